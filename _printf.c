@@ -1,80 +1,170 @@
+
 #include "main.h"
+#include <errno.h>
+#include <poll.h>
 
 /**
- * print_buffer - Prints the contents of a character buffer, if it exists.
+ * print_buffer - Prints the contents of a writer's buffer, if any.
+ *
+ * This function is the default flush callback of writers. It writes all
+ * pending bytes of the writer to its file descriptor, retrying partial and
+ * interrupted writes, and resets the buffer index (length) to zero. On a
+ * non-blocking descriptor it waits in poll() until the rest can be taken;
+ * use an fd_sink_t instead where waiting is not acceptable. A failing
+ * write is recorded in the writer.
  *
- * This function is responsible for printing the contents of the character
- * buffer to the standard output (typically the console). If the buffer
- * contains data, it is printed, and the buffer index (length)
- * is reset to zero.
+ * @out: The writer whose pending bytes are printed.
  *
- * @buffer: The character array containing the data to be printed.
- * @buff_ind: A pointer to an integer indicating
- * the current buffer index/length.
+ * Return: 0 on success, -1 if the write failed.
  */
-void print_buffer(char buffer[], int *buff_ind)
+int print_buffer(writer_t *out)
 {
-	if (*buff_ind > 0)
-		write(1, &buffer[0], *buff_ind);
+	int done = 0, sent;
+	struct pollfd pfd;
+
+	pfd.fd = out->fd;
+	pfd.events = POLLOUT;
+	while (done < out->len && !out->error)
+	{
+		sent = fd_send(out->fd, out->buf + done, out->len - done);
+		if (sent == -1)
+			out->error = 1;
+		else
+			done += sent;
+		if (done < out->len && !out->error &&
+				poll(&pfd, 1, -1) == -1 && errno != EINTR)
+			out->error = 1;
+	}
 
-	*buff_ind = 0;
+	out->len = 0;
+
+	return (out->error ? -1 : 0);
 }
 
 /**
- * _printf - Custom printf function
+ * _vwprintf - Format a string into a writer.
  *
- * This function provides a custom implementation of the printf function
- * for formatted output. It processes the format string and its optional
- * format specifiers, allowing for customized printing of various data types
- * and text. The function supports standard format specifiers and provides
- * options for width, precision, and flags to control formatting.
+ * This function is the formatting engine behind _printf. Runs of plain
+ * text are appended to the writer's buffer and every directive is parsed
+ * and handed to handle_print, whose converters write through the same
+ * writer, so nothing reaches the sink until the buffer fills or the
+ * caller flushes.
+ * A sink that fails while the buffer is full stops the call with -1.
  *
+ * @out: The writer receiving the output.
  * @format: The format string that contains the text and format specifiers.
+ * @list: The arguments for the format specifiers.
  *
- * Return: The total number of characters printed to the standard output.
- *         Returns -1 on error.
+ * Return: The number of characters produced, or -1 on error.
  */
-int _printf(const char *format, ...)
+int _vwprintf(writer_t *out, const char *format, va_list list)
 {
-	int i, printed = 0, printed_chars = 0;
-	int flags, width, precision, size, buff_ind = 0;
-	va_list list;
-	char buffer[BUFF_SIZE];
+	int i, run, printed = 0, printed_chars = 0;
+	spec_t spec;
+	PROF_VAR(t);
 
 	if (format == NULL)
 		return (-1);
 
-	va_start(list, format);
-
-	for (i = 0; format && format[i] != '\0'; i++)
+	for (i = 0; format[i] != '\0'; i++)
 	{
 		if (format[i] != '%')
 		{
-			buffer[buff_ind++] = format[i];
-			if (buff_ind == BUFF_SIZE)
-				print_buffer(buffer, &buff_ind);
-			/* write(1, &format[i], 1);*/
-			printed_chars++;
+			for (run = 1; format[i + run] != '\0'; run++)
+				if (format[i + run] == '%')
+					break;
+			printed_chars += writer_write(out, format + i, run);
+			if (out->error)
+				return (-1);
+			i += run - 1;
 		}
 		else
 		{
-			print_buffer(buffer, &buff_ind);
-			flags = get_flags(format, &i);
-			width = get_width(format, &i, list);
-			precision = get_precision(format, &i, list);
-			size = get_size(format, &i);
-			++i;
-			printed = handle_print(format, &i, list, buffer,
-								   flags, width, precision, size);
+			PROF_START(out, t);
+			parse_spec(format, &i, list, &spec);
+			PROF_END(out, PROF_PARSE, format[i], t, 0);
+			PROF_START(out, t);
+			printed = handle_print(format, &i, list, out, &spec);
+			PROF_END(out, PROF_CONVERT, format[i], t, printed);
 			if (printed == -1)
 				return (-1);
 			printed_chars += printed;
 		}
 	}
 
-	print_buffer(buffer, &buff_ind);
+	return (printed_chars);
+}
+
+/**
+ * _wprintf - Format a string into a writer.
+ *
+ * This function formats like _printf but into any writer, such as an
+ * mmap_sink_t. The output stays buffered in the writer the way stdio
+ * buffers a stream; call writer_flush (or close the sink) to force it out.
+ *
+ * @out: The writer receiving the output.
+ * @format: The format string that contains the text and format specifiers.
+ *
+ * Return: The number of characters produced, or -1 on error.
+ */
+int _wprintf(writer_t *out, const char *format, ...)
+{
+	int printed_chars;
+	va_list list;
+
+	if (out == NULL || format == NULL)
+		return (-1);
+
+	va_start(list, format);
+	printed_chars = _vwprintf(out, format, list);
 	va_end(list);
 
+	if (out->error)
+		return (-1);
+
 	return (printed_chars);
 }
 
+/**
+ * _printf - Custom printf function
+ *
+ * This function provides a custom implementation of the printf function
+ * for formatted output. It processes the format string and its optional
+ * format specifiers, allowing for customized printing of various data types
+ * and text. The function supports standard format specifiers and provides
+ * options for width, precision, and flags to control formatting. Output
+ * goes through the shared stdout sink (see fd_sink_stdout), so a
+ * non-blocking stdout never makes this wait or spin. Under
+ * _printf_set_rate, a suppressed call returns 0 before its format string
+ * is parsed or any argument is read. Under fd_sink_set_dedup, a message
+ * repeating the previous one is held back and counted. Under
+ * _printf_capture, the call is also recorded in the trace.
+ *
+ * @format: The format string that contains the text and format specifiers.
+ *
+ * Return: The total number of characters printed to the standard output.
+ *         Returns -1 on error. Characters the stdout sink had to drop
+ *         are still counted; fd_sink_dropped reports those.
+ */
+int _printf(const char *format, ...)
+{
+	int printed_chars;
+	va_list list;
+	char buffer[BUFF_SIZE], scratch[BUFF_SIZE];
+	writer_t out;
+
+	if (format == NULL)
+		return (-1);
+	if (!stdout_begin(&out, buffer, scratch, format))
+		return (0);
+
+	va_start(list, format);
+	capture_call(format, list);
+	printed_chars = _vwprintf(&out, format, list);
+	va_end(list);
+
+	if (fd_sink_commit(&out) == -1)
+		return (-1);
+
+	return (printed_chars);
+}
@@ -0,0 +1,108 @@
+#include "main.h"
+#include <limits.h>
+
+/**
+ * arena_init - Prepare a bump-pointer arena over caller memory.
+ *
+ * The arena never allocates; strings formatted into it live until the
+ * next arena_reset, which releases all of them at once.
+ *
+ * @arena: The arena to initialize.
+ * @mem: The memory to carve strings from.
+ * @size: The size of @mem.
+ */
+void arena_init(arena_t *arena, char *mem, size_t size)
+{
+	arena->base = mem;
+	arena->cap = size;
+	arena->used = 0;
+}
+
+/**
+ * arena_reset - Release every string formatted into an arena.
+ *
+ * @arena: The arena.
+ */
+void arena_reset(arena_t *arena)
+{
+	arena->used = 0;
+}
+
+/**
+ * arena_full - Flush callback of arena writers.
+ *
+ * The writer's buffer is the whole free part of the arena, so needing a
+ * flush means the string does not fit.
+ *
+ * @out: The writer.
+ *
+ * Return: Always -1.
+ */
+static int arena_full(writer_t *out)
+{
+	out->error = 1;
+
+	return (-1);
+}
+
+/**
+ * _vasprintf - Format a string into an arena.
+ *
+ * The converters write straight into the free part of the arena, so the
+ * string is built in one pass with no sizing pass, copy or allocation.
+ * If it does not fit the arena is left unchanged.
+ *
+ * @arena: The arena.
+ * @strp: Receives the NUL-terminated string, or NULL on failure.
+ * @format: The format string.
+ * @list: The arguments for the format specifiers.
+ *
+ * Return: The length of the string, or -1 if it does not fit or the
+ * format is invalid.
+ */
+int _vasprintf(arena_t *arena, char **strp, const char *format, va_list list)
+{
+	int len;
+	char scratch[BUFF_SIZE];
+	size_t room = arena->cap - arena->used;
+	writer_t out;
+
+	*strp = NULL;
+	if (format == NULL || room == 0)
+		return (-1);
+	if (room - 1 > INT_MAX)
+		room = (size_t)INT_MAX + 1;
+
+	writer_init(&out, arena->base + arena->used, (int)(room - 1), scratch, -1);
+	out.flush = arena_full;
+	len = _vwprintf(&out, format, list);
+	if (len == -1 || out.error)
+		return (-1);
+
+	out.buf[out.len] = '\0';
+	*strp = out.buf;
+	arena->used += out.len + 1;
+
+	return (len);
+}
+
+/**
+ * _asprintf - Format a string into an arena, like asprintf(3).
+ *
+ * @arena: The arena.
+ * @strp: Receives the NUL-terminated string, or NULL on failure.
+ * @format: The format string.
+ *
+ * Return: The length of the string, or -1 on failure.
+ */
+int _asprintf(arena_t *arena, char **strp, const char *format, ...)
+{
+	int len;
+	va_list list;
+
+	va_start(list, format);
+	len = _vasprintf(arena, strp, format, list);
+	va_end(list);
+
+	return (len);
+}
@@ -0,0 +1,168 @@
+#include "main.h"
+
+/**
+ * array_fetch - Load a batch of array elements as magnitudes and signs.
+ *
+ * @base: The start of the array.
+ * @first: The index of the first element to load.
+ * @n: The number of elements to load.
+ * @size: The element size specifier (S_LONG, S_SHORT or 0 for int).
+ * @is_signed: Non-zero for 'd' and 'i', which take signed elements.
+ * @mag: Receives the magnitude of each element.
+ * @neg: Receives 1 for each negative element, 0 otherwise.
+ */
+static void array_fetch(const void *base, int first, int n, int size,
+		int is_signed, unsigned long mag[], char neg[])
+{
+	int j;
+	long v;
+
+	for (j = 0; j < n; j++)
+	{
+		if (size == S_LONG)
+			v = ((const long *)base)[first + j];
+		else if (size == S_SHORT)
+			v = is_signed ? ((const short *)base)[first + j] :
+				(long)((const unsigned short *)base)[first + j];
+		else
+			v = is_signed ? ((const int *)base)[first + j] :
+				(long)((const unsigned int *)base)[first + j];
+		neg[j] = is_signed && v < 0;
+		mag[j] = neg[j] ? 0UL - (unsigned long)v : (unsigned long)v;
+	}
+}
+
+/**
+ * write_array_elem - Write one formatted array element.
+ *
+ * This function lays out the sign or '#' prefix, the zeros required by the
+ * precision and the digits, and pads the result to the width on the left
+ * (or right with '-'), using '0' padding when F_ZERO is set without a
+ * precision, as the scalar integer conversions do.
+ *
+ * @out: The writer receiving the output.
+ * @conv: The element conversion character.
+ * @digits: The element's digits.
+ * @len: The number of digits.
+ * @neg: Non-zero if the element is negative.
+ * @spec: The directive, applied to the element.
+ *
+ * Return: The number of characters written.
+ */
+static int write_array_elem(writer_t *out, char conv, const char *digits,
+		int len, int neg, const spec_t *spec)
+{
+	char prefix[2];
+	int plen = 0, zeros, padd, flags = spec->flags;
+	int precision = spec->precision;
+
+	if (precision == 0 && len == 1 && digits[0] == '0')
+		len = 0;
+	zeros = precision > len ? precision - len : 0;
+	if (neg)
+		prefix[plen++] = '-';
+	else if ((conv == 'd' || conv == 'i') && (flags & (F_PLUS | F_SPACE)))
+		prefix[plen++] = flags & F_PLUS ? '+' : ' ';
+	else if ((flags & F_HASH) && (conv == 'x' || conv == 'X') &&
+			len > 0 && digits[0] != '0')
+		prefix[plen++] = '0', prefix[plen++] = conv;
+	else if ((flags & F_HASH) && conv == 'o' && zeros == 0 &&
+			(len == 0 || digits[0] != '0'))
+		zeros = 1;
+	padd = spec->width - plen - zeros - len;
+
+	if (flags & F_MINUS)
+		return (writer_write(out, prefix, plen) + writer_pad(out, '0', zeros) +
+				writer_write(out, digits, len) + writer_pad(out, ' ', padd));
+	if ((flags & F_ZERO) && precision < 0)
+		return (writer_write(out, prefix, plen) + writer_pad(out, '0', padd) +
+				writer_pad(out, '0', zeros) + writer_write(out, digits, len));
+	return (writer_pad(out, ' ', padd) + writer_write(out, prefix, plen) +
+			writer_pad(out, '0', zeros) + writer_write(out, digits, len));
+}
+
+/**
+ * array_parse - Parse the "[conv separator]" part of an array directive.
+ *
+ * @fmt: The format string.
+ * @ind: On entry the index of '['; on success the index of ']'.
+ * @sep: Receives the separator text, ", " when none is given.
+ * @seplen: Receives the separator length.
+ *
+ * Return: The element conversion character, or 0 if the directive is
+ * malformed.
+ */
+static char array_parse(const char *fmt, int *ind, const char **sep,
+		int *seplen)
+{
+	char conv = fmt[*ind + 1];
+	int n;
+
+	if (conv == '\0' || !strchr("diuoxX", conv))
+		return (0);
+	*sep = &fmt[*ind + 2];
+	for (n = 0; (*sep)[n] != ']'; n++)
+		if ((*sep)[n] == '\0')
+			return (0);
+	*ind += n + 2;
+	*seplen = n;
+	if (n == 0)
+		*sep = ", ", *seplen = 2;
+
+	return (conv);
+}
+
+/**
+ * print_array - Print a whole integer array from one directive.
+ *
+ * This function handles "%[d]", "%[x]" and friends: it takes an int count
+ * and a pointer to the elements, and writes every element with the
+ * directive's flags, width and precision, separated by the text between
+ * the conversion character and ']' (", " when empty), so "%5[d; ]" prints
+ * a five-column, "; "-separated list. The 'h' and 'l' size specifiers,
+ * given before '[', select short and long elements. Elements are converted
+ * ARRAY_BATCH at a time by array_kernel and written straight to the writer.
+ *
+ * @fmt: The format string.
+ * @ind: On entry the index of '['; on return the index of ']'.
+ * @list: The arguments: the element count, then the array pointer.
+ * @out: The writer receiving the output.
+ * @spec: The directive; its flags, width and precision apply to every
+ * element and its size selects the element type.
+ *
+ * Return: The number of characters printed, or -1 if the directive is
+ * malformed.
+ */
+int print_array(const char *fmt, int *ind, va_list list, writer_t *out,
+		const spec_t *spec)
+{
+	const char *sep, *base;
+	int seplen, count, i, j, n, printed = 0, lens[ARRAY_BATCH];
+	char conv, neg[ARRAY_BATCH], slots[ARRAY_BATCH][ARRAY_SLOT];
+	unsigned long mag[ARRAY_BATCH];
+
+	conv = array_parse(fmt, ind, &sep, &seplen);
+	if (conv == 0)
+		return (-1);
+	count = va_arg(list, int);
+	base = va_arg(list, const char *);
+	if (base == NULL)
+		return (writer_write(out, "(null)", 6));
+
+	for (i = 0; i < count; i += n)
+	{
+		n = count - i < ARRAY_BATCH ? count - i : ARRAY_BATCH;
+		array_fetch(base, i, n, spec->size, conv == 'd' || conv == 'i', mag, neg);
+		array_kernel(conv, mag, n, slots, lens);
+		for (j = 0; j < n; j++)
+		{
+			if (i + j > 0)
+				printed += writer_write(out, sep, seplen);
+			printed += write_array_elem(out, conv,
+					&slots[j][ARRAY_SLOT - lens[j]], lens[j], neg[j],
+					spec);
+		}
+	}
+
+	return (printed);
+}
@@ -0,0 +1,171 @@
+#include "main.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#ifdef __SSE2__
+/**
+ * dec8_sse2 - Split a value below 10^8 into eight decimal digits.
+ *
+ * The value is divided by 10^4 with a multiply-shift, both halves are
+ * broadcast into 16-bit lanes and divided by 10^3, 10^2, 10^1 and 10^0 at
+ * once with mulhi, and the tens are subtracted back out, leaving one digit
+ * (0-9) per 16-bit lane, most significant first.
+ *
+ * @value: The value to convert, < 100000000.
+ *
+ * Return: Eight 16-bit digit lanes.
+ */
+static __m128i dec8_sse2(unsigned int value)
+{
+	__m128i abcdefgh, abcd, efgh, v1, v2, v3, v4;
+
+	abcdefgh = _mm_cvtsi32_si128((int)value);
+	abcd = _mm_srli_epi64(_mm_mul_epu32(abcdefgh,
+				_mm_set1_epi32((int)0xd1b71759)), 45);
+	efgh = _mm_sub_epi32(abcdefgh, _mm_mul_epu32(abcd,
+				_mm_set1_epi32(10000)));
+	v1 = _mm_slli_epi64(_mm_unpacklo_epi16(abcd, efgh), 2);
+	v2 = _mm_unpacklo_epi16(v1, v1);
+	v2 = _mm_unpacklo_epi32(v2, v2);
+	v3 = _mm_mulhi_epu16(v2, _mm_setr_epi16(8389, 5243, 13108,
+				(short)32768, 8389, 5243, 13108, (short)32768));
+	v4 = _mm_mulhi_epu16(v3, _mm_setr_epi16(1 << 7, 1 << 11, 1 << 13,
+				(short)(1 << 15), 1 << 7, 1 << 11, 1 << 13, (short)(1 << 15)));
+
+	return (_mm_sub_epi16(v4, _mm_slli_epi64(_mm_mullo_epi16(v4,
+					_mm_set1_epi16(10)), 16)));
+}
+
+/**
+ * hex16_sse2 - Write a 64-bit value as sixteen hexadecimal digits.
+ *
+ * The value is byte-swapped so its most significant byte comes first,
+ * every byte is split into its two nibbles, and the nibbles are turned
+ * into characters with one compare and two adds for all sixteen lanes.
+ *
+ * @v: The value to convert.
+ * @dst: Where the sixteen characters are stored.
+ * @upper: Non-zero for 'A'-'F' digits.
+ */
+void hex16_sse2(unsigned long v, char *dst, int upper)
+{
+	unsigned long be = __builtin_bswap64(v);
+	__m128i x, mask = _mm_set1_epi8(0x0f), nib, alpha;
+
+	x = _mm_loadl_epi64((const __m128i *)&be);
+	nib = _mm_unpacklo_epi8(_mm_and_si128(_mm_srli_epi16(x, 4), mask),
+			_mm_and_si128(x, mask));
+	alpha = _mm_and_si128(_mm_cmpgt_epi8(nib, _mm_set1_epi8(9)),
+			_mm_set1_epi8(upper ? 'A' - '0' - 10 : 'a' - '0' - 10));
+	nib = _mm_add_epi8(_mm_add_epi8(nib, _mm_set1_epi8('0')), alpha);
+	_mm_storeu_si128((__m128i *)dst, nib);
+}
+#endif
+
+/**
+ * array_kernel_dec - Convert a batch of magnitudes to decimal digits.
+ *
+ * With SSE2, two values below 10^8 are converted per iteration into one
+ * 16-byte vector; larger values are split into two 8-digit groups that
+ * share a vector plus up to four leading digits done in scalar code.
+ * Without SSE2 each value is converted with a plain divide loop.
+ *
+ * @mag: The magnitudes to convert.
+ * @n: The number of values, at most ARRAY_BATCH.
+ * @slots: Per-value ARRAY_SLOT-byte slots; digits end at the slot end.
+ * @lens: Receives the digit count of each value.
+ */
+static void array_kernel_dec(const unsigned long *mag, int n,
+		char slots[][ARRAY_SLOT], int lens[])
+{
+	int j, len;
+	unsigned long v, t;
+
+	for (j = 0; j < n; j++)
+	{
+		for (len = 1, t = 10; len < 20 && mag[j] >= t; len++, t *= 10)
+			;
+		lens[j] = len;
+	}
+	for (j = 0; j < n; j++)
+	{
+#ifdef __SSE2__
+		__m128i d;
+
+		v = mag[j];
+		if (j + 1 < n && v < 100000000 && mag[j + 1] < 100000000)
+		{
+			d = _mm_packus_epi16(dec8_sse2(v), dec8_sse2(mag[j + 1]));
+			d = _mm_add_epi8(d, _mm_set1_epi8('0'));
+			_mm_storel_epi64((__m128i *)&slots[j][ARRAY_SLOT - 8], d);
+			_mm_storel_epi64((__m128i *)&slots[j + 1][ARRAY_SLOT - 8],
+					_mm_srli_si128(d, 8));
+			j++;
+			continue;
+		}
+		d = _mm_packus_epi16(dec8_sse2((v / 100000000) % 100000000),
+				dec8_sse2(v % 100000000));
+		_mm_storeu_si128((__m128i *)&slots[j][ARRAY_SLOT - 16],
+				_mm_add_epi8(d, _mm_set1_epi8('0')));
+		for (v /= 10000000000000000UL, t = ARRAY_SLOT - 17; t >= 4; t--)
+			slots[j][t] = '0' + v % 10, v /= 10;
+#else
+		for (v = mag[j], t = ARRAY_SLOT; t > ARRAY_SLOT - (unsigned)lens[j];)
+			slots[j][--t] = '0' + v % 10, v /= 10;
+#endif
+	}
+}
+
+/**
+ * array_kernel - Convert a batch of array elements to digits.
+ *
+ * Decimal and hexadecimal conversions use the vector kernels when the
+ * target has SSE2 (two 32-bit values per 16-byte store for hexadecimal,
+ * see array_kernel_dec for decimal). Octal, and every base on targets
+ * without SSE2, uses shift/mask or divide loops.
+ *
+ * @conv: The element conversion ('d', 'i', 'u', 'o', 'x' or 'X').
+ * @mag: The element magnitudes.
+ * @n: The number of elements, at most ARRAY_BATCH.
+ * @slots: Per-element ARRAY_SLOT-byte slots; digits end at the slot end.
+ * @lens: Receives the digit count of each element.
+ */
+void array_kernel(char conv, const unsigned long *mag, int n,
+		char slots[][ARRAY_SLOT], int lens[])
+{
+	int j, t, shift = conv == 'o' ? 3 : 4;
+	unsigned long v;
+	const char *map = conv == 'X' ? "0123456789ABCDEF" : "0123456789abcdef";
+
+	if (conv != 'o' && conv != 'x' && conv != 'X')
+	{
+		array_kernel_dec(mag, n, slots, lens);
+		return;
+	}
+	for (j = 0; j < n; j++)
+		for (lens[j] = 1, v = mag[j] >> shift; v; v >>= shift)
+			lens[j]++;
+	for (j = 0; j < n; j++)
+	{
+#ifdef __SSE2__
+		char pair[16];
+
+		if (shift == 4 && j + 1 < n && (mag[j] | mag[j + 1]) < 0x100000000UL)
+		{
+			hex16_sse2(mag[j] << 32 | mag[j + 1], pair, conv == 'X');
+			memcpy(&slots[j][ARRAY_SLOT - 8], pair, 8);
+			memcpy(&slots[j + 1][ARRAY_SLOT - 8], pair + 8, 8);
+			j++;
+			continue;
+		}
+		if (shift == 4)
+		{
+			hex16_sse2(mag[j], &slots[j][ARRAY_SLOT - 16], conv == 'X');
+			continue;
+		}
+#endif
+		for (v = mag[j], t = ARRAY_SLOT; t > ARRAY_SLOT - lens[j]; v >>= shift)
+			slots[j][--t] = map[v & ((1UL << shift) - 1)];
+	}
+}
@@ -0,0 +1,127 @@
+#include "main.h"
+
+/**
+ * batch_flush - Flush callback of batches.
+ *
+ * The bytes go to the stdout sink or straight to the descriptor, and the
+ * flush is counted so _vbatch_add can tell whether a record it is undoing
+ * has already been partly written.
+ *
+ * @out: The writer embedded in a batch_t.
+ *
+ * Return: 0 on success, -1 on failure.
+ */
+static int batch_flush(writer_t *out)
+{
+	batch_t *batch = out->ctx;
+	int ret;
+
+	batch->flushes++;
+	if (batch->sink == NULL)
+		return (print_buffer(out));
+	out->ctx = batch->sink;
+	ret = fd_sink_flush(out);
+	out->ctx = batch;
+
+	return (ret);
+}
+
+/**
+ * batch_init - Prepare a batch of records for a file descriptor.
+ *
+ * Records are formatted back to back into the batch's buffer and written
+ * together by batch_commit. Standard output goes through the shared
+ * stdout sink, so batches stay in order with _printf output.
+ *
+ * @batch: The batch to initialize.
+ * @fd: The destination file descriptor.
+ */
+void batch_init(batch_t *batch, int fd)
+{
+	writer_init(&batch->out, batch->buffer, BATCH_SIZE, batch->scratch, fd);
+	batch->out.flush = batch_flush;
+	batch->out.ctx = batch;
+	batch->sink = fd == 1 ? fd_sink_stdout() : NULL;
+	batch->flushes = 0;
+	batch->count = 0;
+	batch->total = 0;
+}
+
+/**
+ * _vbatch_add - Append one formatted record to a batch.
+ *
+ * The record goes through the same engine as _printf; nothing is written
+ * unless the batch outgrows BATCH_SIZE bytes, in which case the records
+ * so far are written early, still in order. The length of each of the
+ * first BATCH_RECORDS records is kept in @batch->lens. A record whose
+ * formatting fails is taken out of the batch again; only when the batch
+ * had to be written early in the middle of it can the part already
+ * written not be taken back, and the rest of it is then dropped.
+ *
+ * @batch: The batch.
+ * @format: The format string of the record.
+ * @list: The arguments for the format specifiers.
+ *
+ * Return: The length of the record, or -1 on error.
+ */
+int _vbatch_add(batch_t *batch, const char *format, va_list list)
+{
+	int len, start = batch->out.len, flushes = batch->flushes;
+
+	len = _vwprintf(&batch->out, format, list);
+	if (len == -1 || batch->out.error)
+	{
+		batch->out.len = batch->flushes == flushes ? start : 0;
+		return (-1);
+	}
+
+	if (batch->count < BATCH_RECORDS)
+		batch->lens[batch->count] = len;
+	batch->count++;
+	batch->total += len;
+
+	return (len);
+}
+
+/**
+ * batch_add - Append one formatted record to a batch.
+ *
+ * @batch: The batch.
+ * @format: The format string of the record.
+ *
+ * Return: The length of the record, or -1 on error.
+ */
+int batch_add(batch_t *batch, const char *format, ...)
+{
+	int len;
+	va_list list;
+
+	va_start(list, format);
+	len = _vbatch_add(batch, format, list);
+	va_end(list);
+
+	return (len);
+}
+
+/**
+ * batch_commit - Write out every record of a batch in one write.
+ *
+ * The batch is emptied and can be reused, so read @batch->lens and
+ * @batch->count first if the record offsets are needed.
+ *
+ * @batch: The batch.
+ *
+ * Return: The total length of the records, or -1 on error.
+ */
+int batch_commit(batch_t *batch)
+{
+	int total = batch->total;
+
+	if (writer_flush(&batch->out) == -1)
+		total = -1;
+	batch->count = 0;
+	batch->total = 0;
+	batch->out.error = 0;
+
+	return (total);
+}
@@ -0,0 +1,171 @@
+#define _GNU_SOURCE
+#include "main.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * bench_arena - Compare _asprintf into an arena with asprintf(3) and with
+ * malloc + snprintf.
+ *
+ *	bench_arena [requests]
+ *
+ * Each request builds BENCH_BATCH response lines that stay alive until
+ * the request ends, then releases them: one arena_reset for _asprintf,
+ * one free per line for the others. The malloc + snprintf path sizes each
+ * line with a first snprintf. Formatting the same lines into a fixed
+ * buffer with _wprintf and snprintf gives the cost without allocation.
+ * Nanoseconds per line are reported on standard error. Build it next to
+ * the library sources:
+ *
+ *	gcc -O2 -Wall -Wextra -pedantic -std=gnu89 -I. bench/bench_arena.c \
+ *		$(ls *.c | grep -v '^main.c$') -o bench_arena -pthread
+ */
+
+#define BENCH_BATCH 2000
+#define BENCH_ARENA (256 * 1024)
+#define BENCH_FORMAT \
+	"{\"id\":%d,\"name\":\"%s\",\"qty\":%u,\"ref\":\"%x\"}\n"
+#define BENCH_ARGS(r, i) (i), "widget", (unsigned int)(r), (unsigned int)(i)
+
+/**
+ * now - Read the monotonic clock.
+ *
+ * Return: The time in nanoseconds.
+ */
+static long now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1000000000L + ts.tv_nsec);
+}
+
+/**
+ * bench_asprintf - Time _asprintf into an arena reset per request.
+ * @requests: How many requests to build.
+ *
+ * Return: Nanoseconds per line, or -1 if a line did not fit.
+ */
+static long bench_asprintf(long requests)
+{
+	static char mem[BENCH_ARENA];
+	static char *lines[BENCH_BATCH];
+	arena_t arena;
+	long t, r;
+	int i;
+
+	arena_init(&arena, mem, BENCH_ARENA);
+	t = now();
+	for (r = 0; r < requests; r++)
+	{
+		for (i = 0; i < BENCH_BATCH; i++)
+			if (_asprintf(&arena, &lines[i], BENCH_FORMAT,
+						BENCH_ARGS(r, i)) == -1)
+				return (-1);
+		arena_reset(&arena);
+	}
+
+	return ((now() - t) / (requests * BENCH_BATCH));
+}
+
+/**
+ * build_line - Build one line the way @mode says.
+ * @mode: 'a' for asprintf, 'm' for malloc + snprintf, 's' for snprintf
+ * into a fixed buffer and 'w' for _wprintf into a fixed buffer.
+ * @line: Receives the allocated line for 'a' and 'm'.
+ * @fixed: The fixed buffer, 256 bytes.
+ * @sink: A mem_sink_t over @fixed.
+ * @r: The request number.
+ * @i: The line number.
+ *
+ * Return: 0 on success, -1 if an allocation failed.
+ */
+static int build_line(char mode, char **line, char *fixed, mem_sink_t *sink,
+		long r, int i)
+{
+	int n;
+
+	if (mode == 'a')
+		return (asprintf(line, BENCH_FORMAT, BENCH_ARGS(r, i)) == -1 ?
+				-1 : 0);
+	if (mode == 's')
+	{
+		snprintf(fixed, 256, BENCH_FORMAT, BENCH_ARGS(r, i));
+		return (0);
+	}
+	if (mode == 'w')
+	{
+		sink->out.len = 0;
+		_wprintf(&sink->out, BENCH_FORMAT, BENCH_ARGS(r, i));
+		return (0);
+	}
+	n = snprintf(NULL, 0, BENCH_FORMAT, BENCH_ARGS(r, i));
+	*line = malloc(n + 1);
+	if (*line == NULL)
+		return (-1);
+	snprintf(*line, n + 1, BENCH_FORMAT, BENCH_ARGS(r, i));
+
+	return (0);
+}
+
+/**
+ * bench_libc - Time one of the other ways of building the lines.
+ * @requests: How many requests to build.
+ * @mode: Which way, as for build_line.
+ *
+ * Return: Nanoseconds per line, or -1 if an allocation failed.
+ */
+static long bench_libc(long requests, char mode)
+{
+	static char *lines[BENCH_BATCH];
+	static char fixed[256];
+	mem_sink_t sink;
+	long t, r;
+	int i;
+
+	mem_sink_open(&sink, fixed, sizeof(fixed));
+	t = now();
+	for (r = 0; r < requests; r++)
+	{
+		for (i = 0; i < BENCH_BATCH; i++)
+			if (build_line(mode, &lines[i], fixed, &sink, r, i))
+				return (-1);
+		for (i = 0; mode != 's' && mode != 'w' && i < BENCH_BATCH; i++)
+			free(lines[i]);
+	}
+
+	return ((now() - t) / (requests * BENCH_BATCH));
+}
+
+/**
+ * main - Run the benchmark.
+ * @argc: Argument count.
+ * @argv: The number of requests, default 1000.
+ *
+ * Return: 0 on success, 1 if a run failed.
+ */
+int main(int argc, char **argv)
+{
+	static char report[BUFF_SIZE];
+	long requests = argc > 1 ? atol(argv[1]) : 1000;
+	long arena = bench_asprintf(requests);
+	long as = bench_libc(requests, 'a'), ms = bench_libc(requests, 'm');
+
+	if (arena < 0 || as < 0 || ms < 0)
+	{
+		_dprintf_sigsafe(2, report, BUFF_SIZE,
+				"bench_arena: run failed\n");
+		return (1);
+	}
+	_dprintf_sigsafe(2, report, BUFF_SIZE,
+			"_asprintf + arena_reset %5ld ns/line\n"
+			"asprintf + free         %5ld ns/line\n"
+			"malloc + snprintf + free %4ld ns/line\n"
+			"_wprintf, no allocation %5ld ns/line\n"
+			"snprintf, no allocation %5ld ns/line\n",
+			arena, as, ms, bench_libc(requests, 'w'),
+			bench_libc(requests, 's'));
+
+	return (0);
+}
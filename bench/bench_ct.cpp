@@ -0,0 +1,121 @@
+#include "../printf.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+/*
+ * bench_ct - Compare the compile-time front end of printf.hpp with the
+ * runtime parser on the same formats.
+ *
+ *	bench_ct [calls] > /dev/null
+ *
+ * A typical log format is run through _wprintf and _wprintf_ct into a
+ * mem_sink_t, which measures the formatting alone, then through _printf
+ * and _printf_ct, which adds the stdout sink. Calls per second are
+ * reported on standard error. Build it next to the library sources:
+ *
+ *	gcc -O2 -std=gnu89 -c $(ls *.c | grep -v '^main.c$')
+ *	g++ -O2 -std=c++20 -I. bench/bench_ct.cpp *.o -o bench_ct -pthread
+ */
+
+#define BENCH_MEM 4096
+
+/**
+ * now - Read the monotonic clock.
+ *
+ * Return: The time in seconds.
+ */
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec + ts.tv_nsec / 1e9);
+}
+
+/**
+ * report - Print one result line on standard error.
+ * @name: What was measured.
+ * @calls: How many calls were made.
+ * @secs: How long they took.
+ * @base: Calls per second of the runtime path, 0 for the runtime path.
+ */
+static void report(const char *name, long calls, double secs, double base)
+{
+	double rate = calls / secs;
+
+	if (base > 0)
+		std::fprintf(stderr, "%-28s %12.0f calls/s  %5.2fx\n",
+			name, rate, rate / base);
+	else
+		std::fprintf(stderr, "%-28s %12.0f calls/s\n", name, rate);
+}
+
+/**
+ * bench_mem - Time both front ends formatting into memory.
+ * @calls: How many calls to make with each.
+ */
+static void bench_mem(long calls)
+{
+	static char mem[BENCH_MEM];
+	mem_sink_t sink;
+	double t, secs;
+	long i;
+
+	mem_sink_open(&sink, mem, BENCH_MEM);
+	t = now();
+	for (i = 0; i < calls; i++)
+	{
+		sink.out.len = 0;
+		_wprintf(&sink.out, "%s: %5ld items, %-8s %#x\n",
+			"orders", i, "ok", (unsigned int)i);
+	}
+	secs = now() - t;
+	report("_wprintf (mem)", calls, secs, 0);
+	t = now();
+	for (i = 0; i < calls; i++)
+	{
+		sink.out.len = 0;
+		_wprintf_ct<"%s: %5ld items, %-8s %#x\n">(&sink.out,
+			"orders", i, "ok", (unsigned int)i);
+	}
+	report("_wprintf_ct (mem)", calls, now() - t, calls / secs);
+}
+
+/**
+ * bench_stdout - Time both front ends printing through the stdout sink.
+ * @calls: How many calls to make with each.
+ */
+static void bench_stdout(long calls)
+{
+	double t, secs;
+	long i;
+
+	t = now();
+	for (i = 0; i < calls; i++)
+		_printf("%s: %5ld items, %-8s %#x\n",
+			"orders", i, "ok", (unsigned int)i);
+	secs = now() - t;
+	report("_printf (stdout)", calls, secs, 0);
+	t = now();
+	for (i = 0; i < calls; i++)
+		_printf_ct<"%s: %5ld items, %-8s %#x\n">("orders", i, "ok",
+			(unsigned int)i);
+	report("_printf_ct (stdout)", calls, now() - t, calls / secs);
+}
+
+/**
+ * main - Run the benchmark.
+ * @argc: Argument count.
+ * @argv: The number of calls per measurement, default 2000000.
+ *
+ * Return: 0.
+ */
+int main(int argc, char **argv)
+{
+	long calls = argc > 1 ? std::atol(argv[1]) : 2000000;
+
+	bench_mem(calls);
+	bench_stdout(calls);
+	return (0);
+}
@@ -0,0 +1,127 @@
+#include "main.h"
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * bench_level - Measure what a disabled leveled call site costs.
+ *
+ *	bench_level [calls] > /dev/null
+ *
+ * A loop that bumps a volatile counter is timed bare, with a
+ * _printf_debug call switched off by _printf_set_level, with one
+ * compiled out by PRINTF_MIN_LEVEL, and with the call enabled. The call's
+ * argument counts its evaluations, to show that disabled sites skip it.
+ * Picoseconds per iteration are reported on standard error. Build it next
+ * to the library sources:
+ *
+ *	gcc -O2 -Wall -Wextra -pedantic -std=gnu89 -I. bench/bench_level.c \
+ *		$(ls *.c | grep -v '^main.c$') -o bench_level -pthread
+ */
+
+static volatile long ticks;
+static long evaluated;
+
+/**
+ * now - Read the monotonic clock.
+ *
+ * Return: The time in nanoseconds.
+ */
+static long now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1000000000L + ts.tv_nsec);
+}
+
+/**
+ * bench_bare - Time the loop without a call site.
+ * @calls: How many iterations.
+ *
+ * Return: Picoseconds per iteration.
+ */
+static long bench_bare(long calls)
+{
+	long t = now(), i;
+
+	for (i = 0; i < calls; i++)
+		ticks++;
+
+	return ((now() - t) * 1000 / calls);
+}
+
+/**
+ * bench_runtime - Time a call site filtered by _printf_level.
+ * @calls: How many iterations.
+ *
+ * Return: Picoseconds per iteration.
+ */
+static long bench_runtime(long calls)
+{
+	long t = now(), i;
+
+	for (i = 0; i < calls; i++)
+	{
+		ticks++;
+		_printf_debug("item %ld\n", (evaluated++, i));
+	}
+
+	return ((now() - t) * 1000 / calls);
+}
+
+#undef PRINTF_MIN_LEVEL
+#define PRINTF_MIN_LEVEL PRINTF_INFO
+
+/**
+ * bench_compiled - Time a call site compiled out by PRINTF_MIN_LEVEL,
+ * which this function sees as PRINTF_INFO.
+ * @calls: How many iterations.
+ *
+ * Return: Picoseconds per iteration.
+ */
+static long bench_compiled(long calls)
+{
+	long t = now(), i;
+
+	for (i = 0; i < calls; i++)
+	{
+		ticks++;
+		_printf_debug("item %ld\n", (evaluated++, i));
+	}
+
+	return ((now() - t) * 1000 / calls);
+}
+
+#undef PRINTF_MIN_LEVEL
+#define PRINTF_MIN_LEVEL PRINTF_DEBUG
+
+/**
+ * main - Run the benchmark.
+ * @argc: Argument count.
+ * @argv: The number of calls, default 200000000.
+ *
+ * Return: 0.
+ */
+int main(int argc, char **argv)
+{
+	static char report[BUFF_SIZE];
+	long calls = argc > 1 ? atol(argv[1]) : 200000000;
+	long bare, runtime, compiled, enabled, skipped;
+
+	bare = bench_bare(calls);
+	_printf_set_level(PRINTF_WARN);
+	runtime = bench_runtime(calls);
+	compiled = bench_compiled(calls);
+	skipped = evaluated;
+	_printf_set_level(PRINTF_DEBUG);
+	enabled = bench_runtime(calls / 100);
+	_dprintf_sigsafe(2, report, BUFF_SIZE,
+			"bare loop           %7ld ps/call\n"
+			"disabled, run time  %7ld ps/call\n"
+			"disabled, compiled  %7ld ps/call\n"
+			"enabled             %7ld ps/call\n"
+			"arguments evaluated by disabled calls: %ld\n",
+			bare, runtime, compiled, enabled, skipped);
+
+	return (0);
+}
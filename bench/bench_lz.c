@@ -0,0 +1,157 @@
+#include "main.h"
+#include <fcntl.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * bench_lz - Report the ratio and throughput of the compressing sink.
+ *
+ *	bench_lz [lines] [file]
+ *
+ * The same verbose debug log is written to a file (default
+ * /tmp/bench_lz.out) through a plain writer with an LZ_SINK_BLOCK buffer
+ * and through an lz_sink_t, closing included. Then one block of that log
+ * is compressed and decompressed in a loop to time the codec alone.
+ * Throughput is in megabytes of log text per second and is reported on
+ * standard error with the compression ratio. Build it next to the library
+ * sources:
+ *
+ *	gcc -O2 -Wall -Wextra -pedantic -std=gnu89 -I. bench/bench_lz.c \
+ *		$(ls *.c | grep -v '^main.c$') -o bench_lz -pthread
+ */
+
+#define BENCH_LINE(out, i) _wprintf(out, \
+	"[debug] worker %d: processed batch %ld of %ld, queue depth %d, " \
+	"state=%s\n", (int)((i) % 8), (i), 4000000L, (int)((i) % 13), \
+	(i) % 5 ? "running" : "draining")
+
+/**
+ * now - Read the monotonic clock.
+ *
+ * Return: The time in nanoseconds.
+ */
+static long now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1000000000L + ts.tv_nsec);
+}
+
+/**
+ * bench_plain - Time writing the log uncompressed.
+ * @fd: The destination.
+ * @lines: How many lines to write.
+ * @bytes: Receives the size of the log.
+ *
+ * Return: The time taken in nanoseconds, or -1 on error.
+ */
+static long bench_plain(int fd, long lines, long *bytes)
+{
+	static char buf[LZ_SINK_BLOCK], scratch[BUFF_SIZE];
+	writer_t out;
+	long t = now(), i;
+
+	*bytes = 0;
+	writer_init(&out, buf, LZ_SINK_BLOCK, scratch, fd);
+	for (i = 0; i < lines; i++)
+		*bytes += BENCH_LINE(&out, i);
+	writer_flush(&out);
+
+	return (out.error ? -1 : now() - t);
+}
+
+/**
+ * bench_sink - Time writing the log through an lz_sink_t.
+ * @fd: The destination.
+ * @lines: How many lines to write.
+ * @packed: Receives the size of the compressed stream.
+ *
+ * Return: The time taken in nanoseconds, or -1 on error.
+ */
+static long bench_sink(int fd, long lines, long *packed)
+{
+	static lz_sink_t sink;
+	long t = now(), i;
+
+	if (lz_sink_open(&sink, fd) == -1)
+		return (-1);
+	for (i = 0; i < lines; i++)
+		BENCH_LINE(&sink.out, i);
+	if (lz_sink_close(&sink) == -1)
+		return (-1);
+	*packed = sink.packed_bytes;
+
+	return (now() - t);
+}
+
+/**
+ * bench_codec - Time lz_compress and lz_decompress on one block of log.
+ * @rounds: How many times to run each.
+ * @pack: Receives the nanoseconds per block for compression.
+ * @unpack: Receives the nanoseconds per block for decompression.
+ *
+ * Return: The size of the block, or -1 if it did not round-trip.
+ */
+static long bench_codec(long rounds, long *pack, long *unpack)
+{
+	static char raw[LZ_SINK_BLOCK], packed[LZ_BOUND(LZ_SINK_BLOCK)];
+	static char back[LZ_SINK_BLOCK];
+	mem_sink_t sink;
+	long t, i;
+	int n = 0;
+
+	mem_sink_open(&sink, raw, LZ_SINK_BLOCK);
+	for (i = 0; sink.out.len < LZ_SINK_BLOCK - 256; i++)
+		BENCH_LINE(&sink.out, i);
+	t = now();
+	for (i = 0; i < rounds; i++)
+		n = lz_compress(raw, sink.out.len, packed);
+	*pack = (now() - t) / rounds;
+	t = now();
+	for (i = 0; i < rounds; i++)
+		lz_decompress(packed, n, back, LZ_SINK_BLOCK);
+	*unpack = (now() - t) / rounds;
+	if (memcmp(raw, back, sink.out.len) != 0)
+		return (-1);
+
+	return (sink.out.len);
+}
+
+/**
+ * main - Run the benchmark.
+ * @argc: Argument count.
+ * @argv: The number of lines and the file to write.
+ *
+ * Return: 0 on success, 1 if a run failed.
+ */
+int main(int argc, char **argv)
+{
+	static char report[BUFF_SIZE];
+	long lines = argc > 1 ? atol(argv[1]) : 2000000;
+	const char *path = argc > 2 ? argv[2] : "/tmp/bench_lz.out";
+	long raw = 0, packed = 0, plain, lz, block, pack, unpack;
+	int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+	plain = fd == -1 ? -1 : bench_plain(fd, lines, &raw);
+	if (fd != -1 && ftruncate(fd, 0) == 0)
+		lseek(fd, 0, SEEK_SET);
+	lz = fd == -1 ? -1 : bench_sink(fd, lines, &packed);
+	block = bench_codec(200, &pack, &unpack);
+	if (plain < 0 || lz < 0 || block < 0)
+	{
+		_dprintf_sigsafe(2, report, BUFF_SIZE,
+				"bench_lz: cannot write %s\n", path);
+		return (1);
+	}
+	close(fd);
+	_dprintf_sigsafe(2, report, BUFF_SIZE,
+			"plain writer  %5ld MB/s, %ld bytes\n"
+			"lz_sink       %5ld MB/s, %ld bytes, ratio %ld.%02ld\n"
+			"lz_compress   %5ld MB/s\nlz_decompress %5ld MB/s\n",
+			raw * 1000 / plain, raw, raw * 1000 / lz, packed,
+			raw / packed, raw * 100 / packed % 100,
+			block * 1000 / pack, block * 1000 / unpack);
+
+	return (0);
+}
@@ -0,0 +1,141 @@
+#include "main.h"
+#include <fcntl.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * bench_par - Measure par_format throughput as a function of the number
+ * of workers.
+ *
+ *	bench_par [records] [max workers] [file]
+ *
+ * An export of @records rows is formatted into a file (default /dev/null,
+ * which leaves the formatting alone) once with a plain writer on the
+ * calling thread, then with par_format and 1, 2, 4, ... workers up to
+ * @max workers (default twice the online CPUs). Records per second and
+ * the speedup over one worker are reported on standard error with the
+ * number of online CPUs, which bounds the speedup. Build it next to the
+ * library sources:
+ *
+ *	gcc -O2 -Wall -Wextra -pedantic -std=gnu89 -I. bench/bench_par.c \
+ *		$(ls *.c | grep -v '^main.c$') -o bench_par -pthread
+ */
+
+/**
+ * struct row - One exported record.
+ * @id: The row id.
+ * @qty: A quantity.
+ * @price: A price in cents.
+ * @name: A name.
+ */
+struct row
+{
+	long id;
+	int qty;
+	unsigned int price;
+	const char *name;
+};
+
+/**
+ * now - Read the monotonic clock.
+ *
+ * Return: The time in nanoseconds.
+ */
+static long now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1000000000L + ts.tv_nsec);
+}
+
+/**
+ * format_row - Format one row, as par_fn.
+ * @out: The worker's writer.
+ * @record: The row.
+ *
+ * Return: The number of characters produced.
+ */
+static int format_row(writer_t *out, const void *record)
+{
+	const struct row *r = record;
+
+	return (_wprintf(out, "%ld,%s,%d,%u.%02u,%#x\n", r->id, r->name,
+				r->qty, r->price / 100, r->price % 100,
+				(unsigned int)r->id));
+}
+
+/**
+ * bench_serial - Time the export with a plain writer on this thread.
+ * @fd: The destination.
+ * @rows: The rows.
+ * @count: The number of rows.
+ *
+ * Return: Records per second, or -1 on error.
+ */
+static long bench_serial(int fd, const struct row *rows, long count)
+{
+	static char buf[PAR_BUF_SIZE], scratch[BUFF_SIZE];
+	writer_t out;
+	long t = now(), i;
+
+	writer_init(&out, buf, PAR_BUF_SIZE, scratch, fd);
+	for (i = 0; i < count; i++)
+		format_row(&out, &rows[i]);
+	writer_flush(&out);
+	t = now() - t;
+
+	return (out.error ? -1 : count * 1000000000L / (t + 1));
+}
+
+/**
+ * main - Run the benchmark.
+ * @argc: Argument count.
+ * @argv: The number of records, the most workers and the file to write.
+ *
+ * Return: 0 on success, 1 if a run failed.
+ */
+int main(int argc, char **argv)
+{
+	static char report[BUFF_SIZE];
+	static const char *names[] = {"bolt", "washer", "hinge", "bracket"};
+	long count = argc > 1 ? atol(argv[1]) : 4000000, i, t, rate, one = 0;
+	int cpus = (int)sysconf(_SC_NPROCESSORS_ONLN), workers;
+	int max = argc > 2 ? atoi(argv[2]) : 2 * cpus;
+	const char *path = argc > 3 ? argv[3] : "/dev/null";
+	int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	struct row *rows = malloc(count * sizeof(*rows));
+
+	if (fd == -1 || rows == NULL)
+		return (1);
+	for (i = 0; i < count; i++)
+	{
+		rows[i].id = i;
+		rows[i].qty = (int)(i % 97);
+		rows[i].price = (unsigned int)(i * 37 % 100000);
+		rows[i].name = names[i % 4];
+	}
+	_dprintf_sigsafe(2, report, BUFF_SIZE, "%d online CPUs\n"
+			"serial writer  %10ld records/s\n", cpus,
+			bench_serial(fd, rows, count));
+	for (workers = 1; workers <= max && workers <= PAR_THREADS;
+			workers *= 2)
+	{
+		lseek(fd, 0, SEEK_SET);
+		t = now();
+		if (par_format(fd, rows, sizeof(*rows), count, format_row,
+					workers) == -1)
+			return (1);
+		rate = count * 1000000000L / (now() - t + 1);
+		if (workers == 1)
+			one = rate;
+		_dprintf_sigsafe(2, report, BUFF_SIZE,
+				"%2d workers %14ld records/s, %ld.%02ldx\n",
+				workers, rate, rate / one,
+				rate * 100 / one % 100);
+	}
+	free(rows);
+	close(fd);
+
+	return (0);
+}
@@ -0,0 +1,156 @@
+#include "main.h"
+#include <wchar.h>
+
+/**
+ * capture_word - Write a numeric argument to the trace.
+ *
+ * The value is zigzag-encoded, so small negative numbers stay short.
+ *
+ * @out: The trace writer.
+ * @v: The argument, sign-extended to a long.
+ */
+static void capture_word(writer_t *out, long v)
+{
+	writer_pad(out, CAP_WORD, 1);
+	capture_varint(out, ((unsigned long)v << 1) ^ (unsigned long)(v >> 63));
+}
+
+/**
+ * capture_stars - Record the '*' width and precision of a directive.
+ *
+ * parse_spec has already taken them from the arguments; a '*' before the
+ * '.' is the width, one after it the precision.
+ *
+ * @out: The trace writer.
+ * @format: The format string.
+ * @start: Index of the directive's '%'.
+ * @end: Index of its conversion character.
+ * @spec: The parsed directive.
+ */
+static void capture_stars(writer_t *out, const char *format, int start,
+		int end, const spec_t *spec)
+{
+	int i, dot = 0;
+
+	for (i = start + 1; i < end; i++)
+	{
+		if (format[i] == '.')
+			dot = 1;
+		else if (format[i] == '*')
+			capture_word(out, dot ? spec->precision : spec->width);
+	}
+}
+
+/**
+ * capture_array - Record the arguments of a "%[...]" directive.
+ *
+ * @out: The trace writer.
+ * @format: The format string.
+ * @i: Index of the '['; left on the ']'.
+ * @list: The arguments: the element count, then the array pointer.
+ * @size: The element size specifier.
+ */
+static void capture_array(writer_t *out, const char *format, int *i,
+		va_list list, int size)
+{
+	int count, elem = size == S_LONG ? sizeof(long) :
+		size == S_SHORT ? sizeof(short) : sizeof(int);
+	const char *base;
+
+	while (format[*i + 1] != '\0' && format[*i] != ']')
+		(*i)++;
+	count = va_arg(list, int);
+	base = va_arg(list, const char *);
+	capture_word(out, count);
+	capture_bytes(out, CAP_ARRAY, base, count > 0 ? (long)count * elem : 0);
+}
+
+/**
+ * capture_arg - Record the argument of one conversion.
+ *
+ * Each conversion's argument is read with the type the conversion itself
+ * reads, size specifier included. What a conversion registered with
+ * _printf_register takes is unknown, so nothing is read for it: a
+ * CAP_CUSTOM argument marks the call as one that cannot be replayed.
+ *
+ * @out: The trace writer.
+ * @spec: The parsed directive.
+ * @list: The arguments.
+ *
+ * Return: 0, or -1 if the conversion is a registered one and no more
+ * arguments may be read.
+ */
+static int capture_arg(writer_t *out, const spec_t *spec, va_list list)
+{
+	const char *s;
+	const wchar_t *ws;
+	int l = spec->size == S_LONG;
+	conv_fn fn = dispatch_lookup(spec->conv);
+
+	if (fn == NULL)
+		return (0);
+	if (fn != (spec->conv == 'T' ? print_time :
+				dispatch_lookup_safe(spec->conv)))
+	{
+		writer_pad(out, CAP_CUSTOM, 1);
+		return (-1);
+	}
+	if (spec->conv == '%' || spec->conv == 'T')
+		return (0);
+	if (l && spec->conv == 'c')
+		capture_word(out, va_arg(list, wint_t));
+	else if (l && spec->conv == 's')
+	{
+		ws = va_arg(list, const wchar_t *);
+		capture_bytes(out, CAP_WIDE, ws,
+				ws ? (long)(wcslen(ws) * sizeof(wchar_t)) : 0);
+	}
+	else if (strchr("sSrRJ", spec->conv))
+	{
+		s = va_arg(list, const char *);
+		capture_bytes(out, CAP_STR, s, s ? (long)strlen(s) : 0);
+	}
+	else if (strchr("diDc", spec->conv) && !l)
+		capture_word(out, va_arg(list, int));
+	else if (strchr("uoxXb", spec->conv) && !l)
+		capture_word(out, va_arg(list, unsigned int));
+	else if (spec->conv == 'p')
+		capture_word(out, (long)va_arg(list, void *));
+	else
+		capture_word(out, va_arg(list, long));
+
+	return (0);
+}
+
+/**
+ * capture_args - Record the arguments a format string consumes.
+ *
+ * The format is walked with parse_spec, exactly as _vwprintf does, so
+ * '*' fields and every conversion take their arguments in the same
+ * order and with the same types. It stops at the first registered
+ * conversion; see capture_arg.
+ *
+ * @out: The trace writer.
+ * @format: The format string.
+ * @list: A copy of the call's arguments.
+ */
+void capture_args(writer_t *out, const char *format, va_list list)
+{
+	int i, start;
+	spec_t spec;
+
+	for (i = 0; format[i] != '\0'; i++)
+	{
+		if (format[i] != '%')
+			continue;
+		start = i;
+		parse_spec(format, &i, list, &spec);
+		capture_stars(out, format, start, i, &spec);
+		if (format[i] == '\0')
+			break;
+		if (format[i] == '[')
+			capture_array(out, format, &i, list, spec.size);
+		else if (capture_arg(out, &spec, list) == -1)
+			break;
+	}
+}
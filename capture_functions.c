@@ -0,0 +1,188 @@
+#include "main.h"
+
+/**
+ * struct capture_format - A format string already defined in the trace.
+ * @format: The format string pointer, NULL if the slot is free.
+ * @hash: Hash of its contents, in case the pointer is reused.
+ * @id: The id its CAP_FORMAT record gave it.
+ */
+struct capture_format
+{
+	const char *format;
+	unsigned long hash;
+	int id;
+};
+
+/*
+ * Non-zero while a trace is being recorded. It is read directly by the
+ * C++ front end, so _printf_ct pays for capture_callf only when capture
+ * is on.
+ */
+int _printf_capture_on;
+
+static struct capture_format capture_formats[CAPTURE_FORMATS];
+static int capture_ids;
+static writer_t capture_out;
+static char capture_buf[CAPTURE_BUF_SIZE], capture_scratch[BUFF_SIZE];
+static pthread_mutex_t capture_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * capture_varint - Write a number to the trace in LEB128 form.
+ *
+ * Seven bits go in each byte, least significant first, with the top bit
+ * set on every byte but the last.
+ *
+ * @out: The trace writer.
+ * @v: The number.
+ */
+void capture_varint(writer_t *out, unsigned long v)
+{
+	char b[10];
+	int n = 0;
+
+	do {
+		b[n] = (char)(v & 0x7F);
+		v >>= 7;
+		b[n++] |= v ? 0x80 : 0;
+	} while (v);
+	writer_write(out, b, n);
+}
+
+/**
+ * capture_bytes - Write a tagged, length-prefixed argument to the trace.
+ *
+ * @out: The trace writer.
+ * @tag: CAP_STR, CAP_WIDE or CAP_ARRAY.
+ * @p: The bytes; NULL is written as a CAP_NULL argument.
+ * @n: The number of bytes.
+ */
+void capture_bytes(writer_t *out, char tag, const void *p, long n)
+{
+	if (p == NULL)
+		tag = CAP_NULL;
+	writer_write(out, &tag, 1);
+	if (p == NULL)
+		return;
+	capture_varint(out, n);
+	writer_write(out, p, n);
+}
+
+/**
+ * capture_format_id - Find the trace id of a format string.
+ *
+ * Format strings are written to the trace once, as a CAP_FORMAT record,
+ * and calls refer to them by id. Formats are looked up by pointer and
+ * contents hash. When the table is three quarters full it starts over,
+ * and the ids are handed out again with new CAP_FORMAT records. The
+ * caller must hold capture_lock.
+ *
+ * @format: The format string.
+ *
+ * Return: The id of @format.
+ */
+static int capture_format_id(const char *format)
+{
+	unsigned long h = 14695981039346656037UL;
+	int i, len;
+	struct capture_format *slot;
+
+	for (len = 0; format[len] != '\0'; len++)
+		h = (h ^ (unsigned char)format[len]) * 1099511628211UL;
+	for (i = h % CAPTURE_FORMATS;; i = (i + 1) % CAPTURE_FORMATS)
+	{
+		slot = &capture_formats[i];
+		if (slot->format == format && slot->hash == h)
+			return (slot->id);
+		if (slot->format == NULL)
+			break;
+	}
+	if (capture_ids >= CAPTURE_FORMATS / 4 * 3)
+	{
+		memset(capture_formats, 0, sizeof(capture_formats));
+		capture_ids = 0;
+		return (capture_format_id(format));
+	}
+
+	slot->format = format, slot->hash = h, slot->id = capture_ids++;
+	writer_pad(&capture_out, CAP_FORMAT, 1);
+	capture_varint(&capture_out, slot->id);
+	capture_varint(&capture_out, len);
+	writer_write(&capture_out, format, len);
+
+	return (slot->id);
+}
+
+/**
+ * capture_call - Record one _printf call in the trace.
+ *
+ * The call is written as a CAP_CALL record: the format id, the decoded
+ * arguments and a CAP_END. Calls from several threads are serialized, so
+ * each record is whole. This returns at once when capture is off.
+ *
+ * @format: The format string.
+ * @list: The call's arguments; they are read from a copy, so @list is
+ * left as it was.
+ */
+void capture_call(const char *format, va_list list)
+{
+	va_list copy;
+	int id;
+
+	if (!__atomic_load_n(&_printf_capture_on, __ATOMIC_RELAXED))
+		return;
+
+	pthread_mutex_lock(&capture_lock);
+	if (_printf_capture_on)
+	{
+		id = capture_format_id(format);
+		writer_pad(&capture_out, CAP_CALL, 1);
+		capture_varint(&capture_out, id);
+		va_copy(copy, list);
+		capture_args(&capture_out, format, copy);
+		va_end(copy);
+		writer_pad(&capture_out, CAP_END, 1);
+		if (capture_out.error)
+			__atomic_store_n(&_printf_capture_on, 0,
+					__ATOMIC_RELAXED);
+	}
+	pthread_mutex_unlock(&capture_lock);
+}
+
+/**
+ * _printf_capture - Start or stop recording _printf calls to a trace.
+ *
+ * While capture is on, every _printf call that passes the rate limiter
+ * is recorded with its format string and the arguments it consumed, as
+ * its conversions decode them: strings, wide strings and arrays by
+ * contents and everything else as a number. Arguments are not recorded
+ * past a conversion registered with _printf_register, whose types are
+ * unknown, and such calls are not replayed. The trace starts with
+ * CAPTURE_MAGIC and is buffered in CAPTURE_BUF_SIZE bytes; stopping
+ * capture flushes it. tools/pf_replay.c plays it back. Capture stops by
+ * itself if a write to @fd fails.
+ *
+ * @fd: The descriptor to write the trace to, or -1 to stop capturing.
+ *
+ * Return: 0 on success, -1 if the trace could not be written.
+ */
+int _printf_capture(int fd)
+{
+	int status = 0;
+
+	pthread_mutex_lock(&capture_lock);
+	if (_printf_capture_on || capture_out.error)
+		status = writer_flush(&capture_out);
+	__atomic_store_n(&_printf_capture_on, 0, __ATOMIC_RELAXED);
+	if (fd >= 0)
+	{
+		writer_init(&capture_out, capture_buf, CAPTURE_BUF_SIZE,
+				capture_scratch, fd);
+		memset(capture_formats, 0, sizeof(capture_formats));
+		capture_ids = 0;
+		writer_write(&capture_out, CAPTURE_MAGIC, CAPTURE_MAGIC_LEN);
+		__atomic_store_n(&_printf_capture_on, 1, __ATOMIC_RELAXED);
+	}
+	pthread_mutex_unlock(&capture_lock);
+
+	return (status);
+}
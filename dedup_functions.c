@@ -0,0 +1,157 @@
+#include "main.h"
+#include <time.h>
+
+#define HASH_K 0x9E3779B97F4A7C15UL
+
+/**
+ * writer_hash - Add bytes to the hash of the message being written.
+ *
+ * writer_write and writer_pad call this for every chunk they append when
+ * the writer is hashing, so the hash is ready the moment the message is
+ * complete. Bytes are mixed eight at a time; up to seven trailing bytes
+ * wait in @out->hash_tail for the next chunk, so the result does not
+ * depend on how the message was split into writes.
+ *
+ * @out: The hashing writer.
+ * @s: The bytes just appended.
+ * @n: The number of bytes.
+ */
+void writer_hash(writer_t *out, const char *s, int n)
+{
+	const unsigned char *p = (const unsigned char *)s;
+	unsigned long h = out->hash, w;
+	int fill = out->hash_len & 7, i = 0;
+
+	out->hash_len += n;
+	for (; fill != 0 && i < n; i++, fill = (fill + 1) & 7)
+	{
+		out->hash_tail |= (unsigned long)p[i] << (fill * 8);
+		if (fill == 7)
+		{
+			h = (h ^ out->hash_tail) * HASH_K;
+			h ^= h >> 32;
+			out->hash_tail = 0;
+		}
+	}
+	for (; i + 8 <= n; i += 8)
+	{
+		memcpy(&w, s + i, 8);
+		h = (h ^ w) * HASH_K;
+		h ^= h >> 32;
+	}
+	for (fill = 0; i < n; i++, fill++)
+		out->hash_tail |= (unsigned long)p[i] << (fill * 8);
+	out->hash = h;
+}
+
+/**
+ * fd_sink_repeats - Write the record that ends a run of repeated messages.
+ *
+ * The caller must hold the sink's lock.
+ *
+ * @sink: The sink.
+ */
+void fd_sink_repeats(fd_sink_t *sink)
+{
+	char buffer[64], scratch[BUFF_SIZE];
+	writer_t out;
+
+	if (sink->repeats == 0)
+		return;
+
+	writer_init(&out, buffer, sizeof(buffer), scratch, sink->fd);
+	_wprintf(&out, "last message repeated %lu times\n", sink->repeats);
+	fd_sink_put(sink, out.buf, out.len);
+	sink->repeats = 0;
+}
+
+/**
+ * fd_sink_repeats_due - Report a run that has been held for too long.
+ *
+ * The caller must hold the sink's lock.
+ *
+ * @sink: The sink.
+ * @now: The current monotonic time in seconds.
+ */
+void fd_sink_repeats_due(fd_sink_t *sink, long now)
+{
+	if (sink->repeats > 0 && now - sink->run_start >= sink->dedup)
+		fd_sink_repeats(sink);
+}
+
+/**
+ * fd_sink_set_dedup - Turn duplicate-line suppression on or off.
+ *
+ * While it is on, a _printf message identical to the previous message on
+ * the sink is held back and counted instead of written. The run ends with
+ * a single "last message repeated N times" record when a different
+ * message arrives or anything else is flushed to the sink. A run that
+ * goes on, or one followed by silence, is reported once it is @seconds
+ * old by the next _printf, fd_sink_drain or the drain at exit, whichever
+ * comes first. Messages are compared by length and a 64-bit hash built
+ * while they are formatted; a message too long for the writer's buffer
+ * is never held back.
+ *
+ * @sink: The sink.
+ * @seconds: Longest time a run is held before it is reported, or 0 to
+ * turn suppression off.
+ */
+void fd_sink_set_dedup(fd_sink_t *sink, int seconds)
+{
+	pthread_mutex_lock(&sink->lock);
+	fd_sink_repeats(sink);
+	sink->prev_len = -1;
+	__atomic_store_n(&sink->dedup, seconds > 0 ? seconds : 0,
+			__ATOMIC_RELAXED);
+	pthread_mutex_unlock(&sink->lock);
+}
+
+/**
+ * fd_sink_commit - Finish a message written through an fd sink.
+ *
+ * This is the final flush of _printf. When the writer was hashing and
+ * still holds the whole message, the message is compared with the sink's
+ * previous one: a repeat is dropped and counted, anything else ends the
+ * current run and is written. Other messages are flushed normally.
+ *
+ * @out: A writer whose ctx is an fd_sink_t.
+ *
+ * Return: 0 on success, -1 if the descriptor has failed.
+ */
+int fd_sink_commit(writer_t *out)
+{
+	fd_sink_t *sink = out->ctx;
+	unsigned long h;
+	struct timespec ts;
+
+	if (!out->hashing || out->hash_len != out->len || out->error)
+		return (writer_flush(out));
+
+	h = (out->hash ^ out->hash_tail) * HASH_K;
+	h = (h ^ (unsigned long)out->len) * HASH_K;
+	h ^= h >> 32;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	pthread_mutex_lock(&sink->lock);
+	if (sink->dedup && out->len == sink->prev_len && h == sink->prev_hash)
+	{
+		if (sink->repeats++ == 0)
+			sink->run_start = ts.tv_sec;
+		else
+			fd_sink_repeats_due(sink, ts.tv_sec);
+		out->len = 0;
+	}
+	else
+	{
+		fd_sink_repeats(sink);
+		fd_sink_put(sink, out->buf, out->len);
+		sink->prev_len = out->len;
+		sink->prev_hash = h;
+		out->len = 0;
+	}
+	if (sink->error)
+		out->error = 1;
+	pthread_mutex_unlock(&sink->lock);
+
+	return (out->error ? -1 : 0);
+}
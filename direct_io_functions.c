@@ -0,0 +1,94 @@
+#define _GNU_SOURCE
+#include "main.h"
+#include <errno.h>
+#include <fcntl.h>
+
+/**
+ * direct_io_fallback - Switch a direct sink to buffered I/O.
+ *
+ * Some file systems accept O_DIRECT when the file is opened and only
+ * reject it with EINVAL on the first read or write. The flag is then
+ * cleared on the open descriptor and the sink carries on through the
+ * page cache.
+ *
+ * @sink: The sink whose I/O was rejected.
+ *
+ * Return: 0 if the sink now uses buffered I/O, -1 if it already did or
+ * the flag could not be cleared.
+ */
+static int direct_io_fallback(direct_sink_t *sink)
+{
+	int flags;
+
+	if (!sink->direct)
+		return (-1);
+	flags = fcntl(sink->fd, F_GETFL);
+	if (flags == -1 || fcntl(sink->fd, F_SETFL, flags & ~O_DIRECT) == -1)
+		return (-1);
+	sink->direct = 0;
+
+	return (0);
+}
+
+/**
+ * direct_io_read - Read one block of a direct sink's file.
+ *
+ * Interrupted reads are retried. The read is not continued after a short
+ * count, since a block at the end of the file is only partly there.
+ *
+ * @sink: The sink.
+ * @buf: Where the bytes go, aligned to @sink->align.
+ * @n: How many to read, a multiple of @sink->align.
+ * @off: File offset to read from, a multiple of @sink->align.
+ *
+ * Return: The number of bytes read, or -1 on error.
+ */
+long direct_io_read(direct_sink_t *sink, char *buf, long n, off_t off)
+{
+	long got;
+
+	while (1)
+	{
+		got = pread(sink->fd, buf, n, off);
+		if (got == -1 && errno == EINTR)
+			continue;
+		if (got == -1 && errno == EINVAL &&
+				direct_io_fallback(sink) == 0)
+			continue;
+		return (got);
+	}
+}
+
+/**
+ * direct_io_write - Write whole blocks to a direct sink's file.
+ *
+ * Interrupted and partial writes are retried, and the sink falls back to
+ * buffered I/O if the file system refuses the direct write.
+ *
+ * @sink: The sink.
+ * @buf: The bytes, aligned to @sink->align.
+ * @n: How many to write; a multiple of @sink->align while the sink is
+ * direct.
+ * @off: File offset to write at, a multiple of @sink->align.
+ *
+ * Return: 0 on success, -1 on error.
+ */
+int direct_io_write(direct_sink_t *sink, const char *buf, long n, off_t off)
+{
+	long done = 0, put;
+
+	while (done < n)
+	{
+		put = pwrite(sink->fd, buf + done, n - done, off + done);
+		if (put == -1 && errno == EINTR)
+			continue;
+		if (put == -1 && errno == EINVAL &&
+				direct_io_fallback(sink) == 0)
+			continue;
+		if (put <= 0)
+			return (-1);
+		done += put;
+	}
+
+	return (0);
+}
@@ -0,0 +1,145 @@
+#define _GNU_SOURCE
+#include "main.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+/**
+ * direct_sink_flush - Flush callback of direct sinks.
+ *
+ * Every whole block in the buffer is written. A partial last block is
+ * written too, padded with zeros to a full block while the sink is
+ * direct, and the file is truncated back to the real end of the output.
+ * That block stays at the start of the buffer and is written again, now
+ * with more in it, by the next flush. When the buffer fills up there is
+ * no partial block, so only a writer_flush or the close pays for one.
+ *
+ * @out: The writer embedded in a direct_sink_t.
+ *
+ * Return: 0 on success, -1 on failure.
+ */
+static int direct_sink_flush(writer_t *out)
+{
+	direct_sink_t *sink = out->ctx;
+	long mask = sink->align - 1, full = out->len & ~mask, n = out->len;
+
+	if (sink->direct && (n & mask) != 0)
+	{
+		n = (n + mask) & ~mask;
+		memset(out->buf + out->len, 0, n - out->len);
+	}
+	if (direct_io_write(sink, out->buf, n, sink->offset) == -1 ||
+			(n > out->len &&
+			 ftruncate(sink->fd, sink->offset + out->len) == -1))
+	{
+		out->error = 1;
+		out->len = 0;
+		return (-1);
+	}
+
+	sink->offset += full;
+	memmove(out->buf, out->buf + full, out->len - full);
+	out->len -= full;
+
+	return (0);
+}
+
+/**
+ * direct_sink_align - Pick the block size for a direct sink's writes.
+ *
+ * @st: The status of the open log file.
+ *
+ * Return: The file system's preferred I/O size if it is a power of two
+ * between 512 and DIRECT_SINK_BUF, DIRECT_SINK_ALIGN otherwise.
+ */
+static int direct_sink_align(const struct stat *st)
+{
+	long size = st->st_blksize;
+
+	if (size < 512 || size > DIRECT_SINK_BUF || (size & (size - 1)) != 0)
+		return (DIRECT_SINK_ALIGN);
+
+	return (size);
+}
+
+/**
+ * direct_sink_open - Open a log file for writing around the page cache.
+ *
+ * The file is opened with O_DIRECT, so its output does not evict other
+ * data from the page cache. Output is collected in an aligned buffer of
+ * about DIRECT_SINK_BUF bytes and written in whole blocks of the file
+ * system's I/O size. New output is appended after the current contents;
+ * a partial last block is read back so it can be rewritten in full.
+ * If the file system does not support O_DIRECT (tmpfs, for one), the
+ * sink falls back to buffered I/O and @sink->direct is 0.
+ * Format into it with _wprintf(&sink->out, ...) and force the output out
+ * with writer_flush(&sink->out). A sink must only be used by one thread
+ * at a time.
+ *
+ * @sink: The sink to initialize.
+ * @path: The path of the log file.
+ *
+ * Return: 0 on success, -1 on failure.
+ */
+int direct_sink_open(direct_sink_t *sink, const char *path)
+{
+	struct stat st;
+	void *buf = NULL;
+	long head = 0;
+	int cap = 0;
+
+	sink->direct = 1;
+	sink->fd = open(path, O_RDWR | O_CREAT | O_DIRECT, 0644);
+	if (sink->fd == -1 && errno == EINVAL)
+	{
+		sink->direct = 0;
+		sink->fd = open(path, O_RDWR | O_CREAT, 0644);
+	}
+	if (sink->fd == -1)
+		return (-1);
+
+	if (fstat(sink->fd, &st) == 0)
+	{
+		sink->align = direct_sink_align(&st);
+		sink->offset = st.st_size & ~((off_t)sink->align - 1);
+		head = st.st_size - sink->offset;
+		cap = DIRECT_SINK_BUF - DIRECT_SINK_BUF % sink->align;
+		if (posix_memalign(&buf, sink->align, cap) != 0)
+			buf = NULL;
+	}
+	if (buf == NULL || (head > 0 && direct_io_read(sink, buf,
+					sink->align, sink->offset) < head))
+	{
+		free(buf);
+		close(sink->fd);
+		return (-1);
+	}
+
+	writer_init(&sink->out, buf, cap, sink->scratch, sink->fd);
+	sink->out.flush = direct_sink_flush;
+	sink->out.ctx = sink;
+	sink->out.len = head;
+
+	return (0);
+}
+
+/**
+ * direct_sink_close - Write out the rest of a direct sink and close it.
+ *
+ * @sink: The sink to close.
+ *
+ * Return: 0 on success, -1 if any output was lost.
+ */
+int direct_sink_close(direct_sink_t *sink)
+{
+	int error;
+
+	writer_flush(&sink->out);
+	error = sink->out.error;
+	free(sink->out.buf);
+	if (close(sink->fd) == -1)
+		error = 1;
+
+	return (error ? -1 : 0);
+}
@@ -0,0 +1,134 @@
+#include "main.h"
+#include <pthread.h>
+
+/*
+ * One slot per byte value: custom and built-in conversions are reached
+ * with the same single indexed load. Readers never lock; slots are read
+ * and written with atomic operations, and registrations are serialized by
+ * register_lock.
+ */
+static conv_fn dispatch_table[256];
+static int dispatch_ready;
+static pthread_mutex_t register_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * builtin_lookup - Find the built-in handler for a conversion character.
+ *
+ * @spec: The conversion character.
+ *
+ * Return: The built-in handler, or NULL if @spec is not built in.
+ */
+static conv_fn builtin_lookup(char spec)
+{
+	int i;
+	fmt_t fmt_types[] = {
+		{'c', print_char}, {'s', print_string},
+		{'%', print_percent}, {'i', print_int},
+		{'d', print_int}, {'b', print_binary},
+		{'u', print_unsigned}, {'o', print_octal},
+		{'x', print_hexadecimal}, {'X', print_hexa_upper},
+		{'p', print_pointer}, {'S', print_non_printable},
+		{'r', print_reverse}, {'R', print_rot13string},
+		{'T', print_time}, {'J', print_json},
+		{'D', print_fixed},
+		{'\0', NULL}};
+
+	for (i = 0; fmt_types[i].fmt != '\0'; i++)
+		if (fmt_types[i].fmt == spec)
+			return (fmt_types[i].fn);
+
+	return (NULL);
+}
+
+/**
+ * dispatch_init - Fill the dispatch table with the built-in handlers.
+ *
+ * This function may run concurrently in several threads. Each slot is only
+ * set if it is still empty, so a late initializer can never overwrite a
+ * handler that was registered in the meantime. It takes no lock, which
+ * keeps the lookup path usable from signal handlers.
+ */
+static void dispatch_init(void)
+{
+	int c;
+	conv_fn expected;
+
+	for (c = 1; c < 256; c++)
+	{
+		expected = NULL;
+		__atomic_compare_exchange_n(&dispatch_table[c], &expected,
+				builtin_lookup((char)c), 0,
+				__ATOMIC_RELEASE, __ATOMIC_RELAXED);
+	}
+
+	__atomic_store_n(&dispatch_ready, 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * dispatch_lookup - Find the handler for a conversion character.
+ *
+ * @spec: The conversion character.
+ *
+ * Return: The registered or built-in handler, or NULL if there is none.
+ */
+conv_fn dispatch_lookup(char spec)
+{
+	if (!__atomic_load_n(&dispatch_ready, __ATOMIC_ACQUIRE))
+		dispatch_init();
+
+	return (__atomic_load_n(&dispatch_table[(unsigned char)spec],
+				__ATOMIC_ACQUIRE));
+}
+
+/**
+ * dispatch_lookup_safe - Find the async-signal-safe handler for a character.
+ *
+ * Only the built-in conversions cleared for signal handlers are returned:
+ * %T (localtime_r and a thread-local cache) is not, and neither is
+ * anything registered with _printf_register. %D is integer arithmetic into
+ * the scratch buffer, like %d, so it is allowed.
+ *
+ * @spec: The conversion character.
+ *
+ * Return: The built-in handler, or NULL if @spec has no safe handler.
+ */
+conv_fn dispatch_lookup_safe(char spec)
+{
+	if (spec == 'T')
+		return (NULL);
+
+	return (builtin_lookup(spec));
+}
+
+/**
+ * _printf_register - Register a handler for a conversion character.
+ *
+ * This function installs @handler for @spec in the dispatch table, where
+ * it is reached exactly like the built-in conversions. A built-in
+ * conversion may be overridden; passing NULL restores the built-in handler
+ * (or removes the conversion if there is none). Characters consumed by the
+ * directive parser (flags, digits, '.', '*', 'l', 'h') and the array
+ * conversion '[' cannot be used.
+ *
+ * @spec: The conversion character.
+ * @handler: The handler to install, or NULL.
+ *
+ * Return: 0 on success, -1 if @spec cannot be used as a conversion.
+ */
+int _printf_register(char spec, conv_fn handler)
+{
+	if (spec == '\0' || is_digit(spec) || strchr("-+# .*lh[", spec))
+		return (-1);
+
+	if (handler == NULL)
+		handler = builtin_lookup(spec);
+
+	pthread_mutex_lock(&register_lock);
+	if (!__atomic_load_n(&dispatch_ready, __ATOMIC_ACQUIRE))
+		dispatch_init();
+	__atomic_store_n(&dispatch_table[(unsigned char)spec], handler,
+			__ATOMIC_RELEASE);
+	pthread_mutex_unlock(&register_lock);
+
+	return (0);
+}
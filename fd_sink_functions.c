@@ -0,0 +1,172 @@
+#include "main.h"
+#include <poll.h>
+#include <time.h>
+
+/**
+ * fd_sink_send - Write as much of the pending queue as the fd will take.
+ *
+ * The caller must hold the sink's lock.
+ *
+ * @sink: The sink.
+ *
+ * Return: The number of bytes still pending, or -1 on error.
+ */
+static int fd_sink_send(fd_sink_t *sink)
+{
+	int chunk, sent;
+
+	while (sink->queued > 0)
+	{
+		chunk = FD_SINK_QUEUE - sink->head;
+		if (chunk > sink->queued)
+			chunk = sink->queued;
+		sent = fd_send(sink->fd, sink->queue + sink->head, chunk);
+		if (sent == -1)
+			return (-1);
+		sink->head = (sink->head + sent) % FD_SINK_QUEUE;
+		sink->queued -= sent;
+		if (sent < chunk)
+			break;
+	}
+	if (sink->queued == 0)
+		sink->head = 0;
+
+	return (sink->queued);
+}
+
+/**
+ * fd_sink_queue - Keep bytes the descriptor could not take for later.
+ *
+ * When the queue cannot hold them the sink's policy decides: FD_SINK_WAIT
+ * first waits up to the timeout for the descriptor to drain it, then like
+ * FD_SINK_DROP_NEW keeps what fits and drops the rest; FD_SINK_DROP_OLD
+ * discards the oldest pending bytes instead. Dropped bytes are counted.
+ * The caller must hold the sink's lock.
+ *
+ * @sink: The sink.
+ * @s: The bytes to keep.
+ * @n: The number of bytes.
+ */
+static void fd_sink_queue(fd_sink_t *sink, const char *s, int n)
+{
+	int drop, tail, chunk, left;
+	struct pollfd pfd;
+
+	pfd.fd = sink->fd;
+	pfd.events = POLLOUT;
+	while (sink->policy == FD_SINK_WAIT && n > FD_SINK_QUEUE - sink->queued &&
+			sink->queued > 0 && poll(&pfd, 1, sink->timeout) > 0)
+	{
+		left = sink->queued;
+		if (fd_sink_send(sink) == -1)
+		{
+			sink->error = 1;
+			return;
+		}
+		if (sink->queued == left)
+			break;
+	}
+	if (sink->policy == FD_SINK_DROP_OLD && n > FD_SINK_QUEUE - sink->queued)
+	{
+		drop = n > FD_SINK_QUEUE ? n - FD_SINK_QUEUE : 0;
+		s += drop, n -= drop, sink->dropped += drop;
+		drop = n - (FD_SINK_QUEUE - sink->queued);
+		sink->head = (sink->head + drop) % FD_SINK_QUEUE;
+		sink->queued -= drop, sink->dropped += drop;
+	}
+	if (n > FD_SINK_QUEUE - sink->queued)
+	{
+		sink->dropped += n - (FD_SINK_QUEUE - sink->queued);
+		n = FD_SINK_QUEUE - sink->queued;
+	}
+
+	tail = (sink->head + sink->queued) % FD_SINK_QUEUE;
+	chunk = FD_SINK_QUEUE - tail < n ? FD_SINK_QUEUE - tail : n;
+	memcpy(sink->queue + tail, s, chunk);
+	memcpy(sink->queue, s + chunk, n - chunk);
+	sink->queued += n;
+}
+
+/**
+ * fd_sink_put - Write bytes to an fd sink, queueing what it cannot take.
+ *
+ * Bytes queued by earlier calls are retried first, so output keeps its
+ * order; the new bytes are then written directly if the queue has
+ * emptied, and whatever the descriptor cannot take now is queued. The
+ * caller must hold the sink's lock.
+ *
+ * @sink: The sink.
+ * @s: The bytes.
+ * @n: The number of bytes.
+ */
+void fd_sink_put(fd_sink_t *sink, const char *s, int n)
+{
+	int left, sent = 0;
+
+	left = fd_sink_send(sink);
+	if (left == 0)
+		sent = fd_send(sink->fd, s, n);
+	if (left == -1 || sent == -1)
+		sink->error = 1;
+	else if (sent < n)
+		fd_sink_queue(sink, s + sent, n - sent);
+}
+
+/**
+ * fd_sink_flush - Flush callback of fd sinks.
+ *
+ * The writer's bytes go out through fd_sink_put. Only FD_SINK_WAIT ever
+ * waits, and never longer than the sink's timeout. Any writer whose
+ * context is an fd_sink_t may use this callback, which is how _printf
+ * shares the stdout sink between threads. Flushed bytes end any run of
+ * repeated messages (see fd_sink_set_dedup).
+ *
+ * @out: A writer whose ctx is an fd_sink_t.
+ *
+ * Return: 0 on success, -1 if the descriptor has failed.
+ */
+int fd_sink_flush(writer_t *out)
+{
+	fd_sink_t *sink = out->ctx;
+
+	pthread_mutex_lock(&sink->lock);
+	fd_sink_repeats(sink);
+	fd_sink_put(sink, out->buf, out->len);
+	sink->prev_len = -1;
+	if (sink->error)
+		out->error = 1;
+	pthread_mutex_unlock(&sink->lock);
+
+	out->len = 0;
+
+	return (out->error ? -1 : 0);
+}
+
+/**
+ * fd_sink_drain - Retry the bytes an fd sink is holding back.
+ *
+ * Flushes retry on their own; call this to push pending output out
+ * between calls, for example when an event loop sees the descriptor
+ * become writable or on a timer. A run of repeated messages that has
+ * been held for its full time is reported first. It never waits.
+ *
+ * @sink: The sink.
+ *
+ * Return: The number of bytes still pending, or -1 on error.
+ */
+int fd_sink_drain(fd_sink_t *sink)
+{
+	int left;
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	pthread_mutex_lock(&sink->lock);
+	if (sink->dedup)
+		fd_sink_repeats_due(sink, ts.tv_sec);
+	left = fd_sink_send(sink);
+	if (left == -1)
+		sink->error = 1;
+	pthread_mutex_unlock(&sink->lock);
+
+	return (left);
+}
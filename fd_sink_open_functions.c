@@ -0,0 +1,144 @@
+#include "main.h"
+#include <poll.h>
+
+/**
+ * fd_sink_open - Set up output to a file descriptor that may not block.
+ *
+ * Bytes the descriptor cannot take right away (a short write or EAGAIN on
+ * a non-blocking pipe or socket) are kept in a queue of FD_SINK_QUEUE
+ * bytes and retried, in order, on the next flush. @policy decides what
+ * happens when the queue is full:
+ * FD_SINK_DROP_NEW keeps the queue and drops the new bytes,
+ * FD_SINK_DROP_OLD drops the oldest queued bytes to make room,
+ * FD_SINK_WAIT waits up to @timeout ms for the descriptor, then drops the
+ * new bytes that still do not fit.
+ * Format into it with _wprintf(&sink->out, ...) from one thread; other
+ * writers may share the sink through fd_sink_flush.
+ *
+ * @sink: The sink to initialize.
+ * @fd: The destination file descriptor; it is not closed by the sink.
+ * @policy: The policy for a full queue.
+ * @timeout: Longest wait in milliseconds for FD_SINK_WAIT.
+ *
+ * Return: 0 on success, -1 on failure.
+ */
+int fd_sink_open(fd_sink_t *sink, int fd, int policy, int timeout)
+{
+	if (pthread_mutex_init(&sink->lock, NULL) != 0)
+		return (-1);
+
+	sink->fd = fd;
+	sink->policy = policy;
+	sink->timeout = timeout;
+	sink->error = 0;
+	sink->head = 0;
+	sink->queued = 0;
+	sink->dropped = 0;
+	sink->dedup = 0;
+	sink->prev_len = -1;
+	sink->repeats = 0;
+	writer_init(&sink->out, sink->buffer, BUFF_SIZE, sink->scratch, fd);
+	sink->out.flush = fd_sink_flush;
+	sink->out.ctx = sink;
+
+	return (0);
+}
+
+/**
+ * fd_sink_set_policy - Change what an fd sink does when its queue is full.
+ *
+ * @sink: The sink.
+ * @policy: FD_SINK_DROP_NEW, FD_SINK_DROP_OLD or FD_SINK_WAIT.
+ * @timeout: Longest wait in milliseconds for FD_SINK_WAIT.
+ */
+void fd_sink_set_policy(fd_sink_t *sink, int policy, int timeout)
+{
+	pthread_mutex_lock(&sink->lock);
+	sink->policy = policy;
+	sink->timeout = timeout;
+	pthread_mutex_unlock(&sink->lock);
+}
+
+/**
+ * fd_sink_finish - Write out everything an fd sink is holding.
+ *
+ * The sink's writer is flushed, a pending "repeated" record is written
+ * and the queue is drained, waiting up to @timeout ms at a time while the
+ * descriptor keeps accepting bytes. What is still pending after that is
+ * discarded and counted as dropped. The sink stays usable.
+ *
+ * @sink: The sink.
+ * @timeout: Longest wait in milliseconds for the descriptor to move.
+ *
+ * Return: The number of bytes that had to be dropped.
+ */
+int fd_sink_finish(fd_sink_t *sink, int timeout)
+{
+	int left, before;
+	struct pollfd pfd;
+
+	writer_flush(&sink->out);
+	pthread_mutex_lock(&sink->lock);
+	fd_sink_repeats(sink);
+	pthread_mutex_unlock(&sink->lock);
+	pfd.fd = sink->fd;
+	pfd.events = POLLOUT;
+	left = fd_sink_drain(sink);
+	do {
+		before = left;
+		if (left > 0 && poll(&pfd, 1, timeout) > 0)
+			left = fd_sink_drain(sink);
+	} while (left > 0 && left < before);
+	if (left <= 0)
+		return (0);
+
+	pthread_mutex_lock(&sink->lock);
+	sink->dropped += left;
+	sink->head = 0;
+	sink->queued = 0;
+	pthread_mutex_unlock(&sink->lock);
+
+	return (left);
+}
+
+/**
+ * fd_sink_dropped - Get the number of bytes an fd sink has dropped.
+ *
+ * Bytes are dropped when the queue is full (see fd_sink_open) and when
+ * the descriptor stops accepting them at close or exit. A _printf whose
+ * bytes were dropped still counts them in its return value, so this is
+ * how to tell that standard output lost data: fd_sink_dropped(
+ * fd_sink_stdout()).
+ *
+ * @sink: The sink.
+ *
+ * Return: The total number of bytes dropped so far.
+ */
+unsigned long fd_sink_dropped(fd_sink_t *sink)
+{
+	unsigned long dropped;
+
+	pthread_mutex_lock(&sink->lock);
+	dropped = sink->dropped;
+	pthread_mutex_unlock(&sink->lock);
+
+	return (dropped);
+}
+
+/**
+ * fd_sink_close - Flush an fd sink and release it.
+ *
+ * Pending output is written as by fd_sink_finish, with the sink's own
+ * timeout.
+ *
+ * @sink: The sink to close.
+ *
+ * Return: 0 on success, -1 if any output was dropped or lost.
+ */
+int fd_sink_close(fd_sink_t *sink)
+{
+	fd_sink_finish(sink, sink->timeout);
+	pthread_mutex_destroy(&sink->lock);
+
+	return (sink->error || sink->dropped ? -1 : 0);
+}
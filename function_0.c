@@ -11,43 +11,17 @@
  *
  * @types: A va_list containing the unsigned integer to be printed in octal
  * format.
- * @buffer: The buffer used for print operations.
- * @flags: Formatting flags for special handling.
- * @width: The desired width of the output.
- * @precision: The precision specification.
- * @size: Size specifier for unsigned integers.
+ * @out: The writer receiving the output.
+ * @spec: The parsed directive (flags, width, precision, size).
  *
  * Return: The number of characters printed.
  */
-int print_octal(va_list types, char buffer[],
-				int flags, int width, int precision, int size)
+int print_octal(va_list types, writer_t *out, const spec_t *spec)
 {
-
-	int i = BUFF_SIZE - 2;
 	unsigned long int num = va_arg(types, unsigned long int);
-	unsigned long int init_num = num;
-
-	UNUSED(width);
-
-	num = convert_size_unsgnd(num, size);
-
-	if (num == 0)
-		buffer[i--] = '0';
-
-	buffer[BUFF_SIZE - 1] = '\0';
 
-	while (num > 0)
-	{
-		buffer[i--] = (num % 8) + '0';
-		num /= 8;
-	}
-
-	if (flags & F_HASH && init_num != 0)
-		buffer[i--] = '0';
-
-	i++;
-
-	return (write_unsgnd(0, i, buffer, flags, width, precision, size));
+	return (print_unsigned_value(num, 8, "01234567", 0, out,
+								 spec));
 }
 
 /**
@@ -62,46 +36,19 @@ int print_octal(va_list types, char buffer[],
  * @types: A va_list containing the unsigned integer to be printed in
  * hexadecimal.
  * @map_to: A character array used to map hexadecimal digits.
- * @buffer: The buffer used for print operations.
- * @flags: Formatting flags for special handling.
+ * @out: The writer receiving the output.
+ * @spec: The parsed directive (flags, width, precision, size).
  * @flag_ch: The character used to prefix the hexadecimal value.
- * @width: The desired width of the output.
- * @precision: The precision specification.
- * @size: Size specifier for unsigned integers.
  *
  * Return: The number of characters printed.
  */
-int print_hexa(va_list types, char map_to[], char buffer[],
-			   int flags, char flag_ch, int width, int precision, int size)
+int print_hexa(va_list types, char map_to[], writer_t *out,
+			   const spec_t *spec, char flag_ch)
 {
-	int i = BUFF_SIZE - 2;
 	unsigned long int num = va_arg(types, unsigned long int);
-	unsigned long int init_num = num;
-
-	UNUSED(width);
-
-	num = convert_size_unsgnd(num, size);
 
-	if (num == 0)
-		buffer[i--] = '0';
-
-	buffer[BUFF_SIZE - 1] = '\0';
-
-	while (num > 0)
-	{
-		buffer[i--] = map_to[num % 16];
-		num /= 16;
-	}
-
-	if (flags & F_HASH && init_num != 0)
-	{
-		buffer[i--] = flag_ch;
-		buffer[i--] = '0';
-	}
-
-	i++;
-
-	return (write_unsgnd(0, i, buffer, flags, width, precision, size));
+	return (print_unsigned_value(num, 16, map_to, flag_ch, out,
+								 spec));
 }
 
 /**
@@ -114,19 +61,15 @@ int print_hexa(va_list types, char map_to[], char buffer[],
  *
  * @types: A va_list containing the unsigned integer to be printed in
  * hexadecimal.
- * @buffer: The buffer used for print operations.
- * @flags: Formatting flags for special handling.
- * @width: The desired width of the output.
- * @precision: The precision specification.
- * @size: Size specifier for unsigned integers.
+ * @out: The writer receiving the output.
+ * @spec: The parsed directive (flags, width, precision, size).
  *
  * Return: The number of characters printed.
  */
-int print_hexadecimal(va_list types, char buffer[],
-					  int flags, int width, int precision, int size)
+int print_hexadecimal(va_list types, writer_t *out, const spec_t *spec)
 {
-	return (print_hexa(types, "0123456789abcdef", buffer,
-					   flags, 'x', width, precision, size));
+	return (print_hexa(types, "0123456789abcdef", out,
+					   spec, 'x'));
 }
 
 /**
@@ -140,19 +83,15 @@ int print_hexadecimal(va_list types, char buffer[],
  *
  * @types: A va_list containing the unsigned integer to be printed in uppercase
  *         hexadecimal format.
- * @buffer: The buffer used for print operations.
- * @flags: Formatting flags for special handling.
- * @width: The desired width of the output.
- * @precision: The precision specification.
- * @size: Size specifier for unsigned integers.
+ * @out: The writer receiving the output.
+ * @spec: The parsed directive (flags, width, precision, size).
  *
  * Return: The number of characters printed.
  */
-int print_hexa_upper(va_list types, char buffer[],
-					 int flags, int width, int precision, int size)
+int print_hexa_upper(va_list types, writer_t *out, const spec_t *spec)
 {
-	return (print_hexa(types, "0123456789ABCDEF", buffer,
-					   flags, 'X', width, precision, size));
+	return (print_hexa(types, "0123456789ABCDEF", out,
+					   spec, 'X'));
 }
 
 /**
@@ -164,34 +103,15 @@ int print_hexa_upper(va_list types, char buffer[],
  * precision.
  *
  * @types: A va_list containing the unsigned integer to be printed.
- * @buffer: The buffer used for print operations.
- * @flags: Formatting flags for special handling.
- * @width: The desired width of the output.
- * @precision: The precision specification.
- * @size: Size specifier for unsigned integers.
+ * @out: The writer receiving the output.
+ * @spec: The parsed directive (flags, width, precision, size).
  *
  * Return: The number of characters printed.
  */
-int print_unsigned(va_list types, char buffer[],
-				   int flags, int width, int precision, int size)
+int print_unsigned(va_list types, writer_t *out, const spec_t *spec)
 {
-	int i = BUFF_SIZE - 2;
 	unsigned long int num = va_arg(types, unsigned long int);
 
-	num = convert_size_unsgnd(num, size);
-
-	if (num == 0)
-		buffer[i--] = '0';
-
-	buffer[BUFF_SIZE - 1] = '\0';
-
-	while (num > 0)
-	{
-		buffer[i--] = (num % 10) + '0';
-		num /= 10;
-	}
-
-	i++;
-
-	return (write_unsgnd(0, i, buffer, flags, width, precision, size));
+	return (print_unsigned_value(num, 10, "0123456789", 0, out,
+								 spec));
 }
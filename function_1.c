@@ -9,45 +9,42 @@
  * It considers optional formatting
  * specifications such as flags, width, and size specifiers but does not
  * process them. The function scans the input string for non-printable
- * characters and replaces them with their hexadecimal codes.
+ * characters and replaces them with their hexadecimal codes. Printable
+ * runs are written straight from the string, so its length is not limited
+ * by the size of the buffers.
  *
  * @types: A va_list containing the string to be printed with non-printable
  * characters replaced.
- * @buffer: The buffer used for print operations.
- * @flags: Formatting flags.
- * @width: The desired width of the output.
- * @precision: The precision specification.
- * @size: Size specifier for formatting.
+ * @out: The writer receiving the output.
+ * @spec: The parsed directive (flags, width, precision, size).
  *
  * Return: The number of characters printed, including hexadecimal codes.
  */
-int print_non_printable(va_list types, char buffer[],
-						int flags, int width, int precision, int size)
+int print_non_printable(va_list types, writer_t *out, const spec_t *spec)
 {
-	int i = 0, offset = 0;
+	char code[4];
+	int i = 0, run, printed = 0;
 	char *str = va_arg(types, char *);
 
-	UNUSED(flags);
-	UNUSED(width);
-	UNUSED(precision);
-	UNUSED(size);
+	UNUSED(spec);
 
 	if (str == NULL)
-		return (write(1, "(null)", 6));
+		return (writer_write(out, "(null)", 6));
 
 	while (str[i] != '\0')
 	{
-		if (is_printable(str[i]))
-			buffer[i + offset] = str[i];
-		else
-			offset += append_hexa_code(str[i], buffer, i + offset);
-
+		for (run = 0; is_printable(str[i + run]); run++)
+			;
+		printed += writer_write(out, str + i, run);
+		i += run;
+		if (str[i] == '\0')
+			break;
+		printed += writer_write(out, code,
+				append_hexa_code(str[i], code, 0) + 1);
 		i++;
 	}
 
-	buffer[i + offset] = '\0';
-
-	return (write(1, buffer, i + offset));
+	return (printed);
 }
 
 /**
@@ -60,53 +57,16 @@ int print_non_printable(va_list types, char buffer[],
  * addition of a plus sign or space before the address.
  *
  * @types: A va_list containing the pointer address to be printed.
- * @buffer: The buffer used for print operations.
- * @flags: Formatting flags (e.g., zero-padding, plus sign).
- * @width: The desired width of the output.
- * @precision: The precision specification.
- * @size: Size specifier for formatting.
+ * @out: The writer receiving the output.
+ * @spec: The parsed directive (flags, width, precision, size).
  *
  * Return: The number of characters printed for the pointer address.
  */
-int print_pointer(va_list types, char buffer[],
-				  int flags, int width, int precision, int size)
+int print_pointer(va_list types, writer_t *out, const spec_t *spec)
 {
-	char extra_c = 0, padd = ' ';
-	int ind = BUFF_SIZE - 2, length = 2, padd_start = 1;
-	unsigned long num_addrs;
-	char map_to[] = "0123456789abcdef";
 	void *addrs = va_arg(types, void *);
 
-	UNUSED(width);
-	UNUSED(size);
-
-	if (addrs == NULL)
-		return (write(1, "(nil)", 5));
-
-	buffer[BUFF_SIZE - 1] = '\0';
-	UNUSED(precision);
-
-	num_addrs = (unsigned long)addrs;
-
-	while (num_addrs > 0)
-	{
-		buffer[ind--] = map_to[num_addrs % 16];
-		num_addrs /= 16;
-		length++;
-	}
-
-	if ((flags & F_ZERO) && !(flags & F_MINUS))
-		padd = '0';
-	if (flags & F_PLUS)
-		extra_c = '+', length++;
-	else if (flags & F_SPACE)
-		extra_c = ' ', length++;
-
-	ind++;
-
-	/*return (write(1, &buffer[i], BUFF_SIZE - i - 1));*/
-	return (write_pointer(buffer, ind, length,
-						  width, flags, padd, extra_c, padd_start));
+	return (print_pointer_value(addrs, out, spec));
 }
 
 /**
@@ -119,30 +79,22 @@ int print_pointer(va_list types, char buffer[],
  *
  * @types: A va_list containing the string to be transformed and printed
  * using ROT13.
- * @buffer: The buffer used for print operations.
- * @flags: Formatting flags.
- * @width: The desired width of the output.
- * @precision: The precision specification.
- * @size: Size specifier for formatting.
+ * @out: The writer receiving the output.
+ * @spec: The parsed directive (flags, width, precision, size).
  *
  * Return: The number of characters printed after ROT13 transformation.
  */
-int print_rot13string(va_list types, char buffer[],
-					  int flags, int width, int precision, int size)
+int print_rot13string(va_list types, writer_t *out, const spec_t *spec)
 {
 	char x;
 	char *str;
 	unsigned int i, j;
 	int count = 0;
 	char in[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
-	char out[] = "NOPQRSTUVWXYZABCDEFGHIJKLMnopqrstuvwxyzabcdefghijklm";
+	char rot[] = "NOPQRSTUVWXYZABCDEFGHIJKLMnopqrstuvwxyzabcdefghijklm";
 
 	str = va_arg(types, char *);
-	UNUSED(buffer);
-	UNUSED(flags);
-	UNUSED(width);
-	UNUSED(precision);
-	UNUSED(size);
+	UNUSED(spec);
 
 	if (str == NULL)
 		str = "(AHYY)";
@@ -152,8 +104,8 @@ int print_rot13string(va_list types, char buffer[],
 		{
 			if (in[j] == str[i])
 			{
-				x = out[j];
-				write(1, &x, 1);
+				x = rot[j];
+				writer_write(out, &x, 1);
 				count++;
 				break;
 			}
@@ -161,7 +113,7 @@ int print_rot13string(va_list types, char buffer[],
 		if (!in[j])
 		{
 			x = str[i];
-			write(1, &x, 1);
+			writer_write(out, &x, 1);
 			count++;
 		}
 	}
@@ -177,34 +129,23 @@ int print_rot13string(va_list types, char buffer[],
  * and prints the reversed string to the standard output.
  *
  * @types: A va_list containing the string to be reversed and printed.
- * @buffer: The buffer used for print operations.
- * @flags: Formatting flags.
- * @width: The desired width of the output.
- * @precision: The precision specification.
- * @size: Size specifier for formatting.
+ * @out: The writer receiving the output.
+ * @spec: The parsed directive (flags, width, precision, size).
  *
  * Return: The number of characters printed in reverse order.
  */
 
-int print_reverse(va_list types, char buffer[],
-				  int flags, int width, int precision, int size)
+int print_reverse(va_list types, writer_t *out, const spec_t *spec)
 {
 	char *str;
 	int i, count = 0;
 
-	UNUSED(buffer);
-	UNUSED(flags);
-	UNUSED(width);
-	UNUSED(size);
+	UNUSED(spec);
 
 	str = va_arg(types, char *);
 
 	if (str == NULL)
-	{
-		UNUSED(precision);
-
 		str = ")Null(";
-	}
 	for (i = 0; str[i]; i++)
 		;
 
@@ -212,7 +153,7 @@ int print_reverse(va_list types, char buffer[],
 	{
 		char z = str[i];
 
-		write(1, &z, 1);
+		writer_write(out, &z, 1);
 		count++;
 	}
 	return (count);
@@ -0,0 +1,136 @@
+#include "main.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/**
+ * json_scan - Find the next byte a JSON string must escape.
+ *
+ * Those are '"', '\\' and control bytes below 0x20. With SSE2, sixteen
+ * bytes are tested per step with three compares and a movemask.
+ *
+ * @s: The string.
+ * @i: Where to start.
+ * @len: The length of @s.
+ *
+ * Return: The index of the next byte to escape, or @len if there is none.
+ */
+static int json_scan(const char *s, int i, int len)
+{
+#ifdef __SSE2__
+	__m128i v, quote = _mm_set1_epi8('"'), bslash = _mm_set1_epi8('\\');
+	__m128i ctl = _mm_set1_epi8(0x1F);
+	unsigned int mask;
+
+	for (; i + 16 <= len; i += 16)
+	{
+		v = _mm_loadu_si128((const __m128i *)(s + i));
+		mask = (unsigned int)_mm_movemask_epi8(_mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(v, quote),
+					_mm_cmpeq_epi8(v, bslash)),
+				_mm_cmpeq_epi8(_mm_max_epu8(v, ctl), ctl)));
+		if (mask)
+			return (i + __builtin_ctz(mask));
+	}
+#endif
+	for (; i < len; i++)
+		if ((unsigned char)s[i] < 0x20 || s[i] == '"' || s[i] == '\\')
+			return (i);
+
+	return (len);
+}
+
+/**
+ * json_escape - Write the body of a JSON string, or measure it.
+ *
+ * Clean runs are copied in bulk; each byte that must be escaped gets its
+ * short escape (\n, \t, ...) or \u00XX from a table.
+ *
+ * @s: The string.
+ * @len: The number of bytes of @s to write.
+ * @out: The writer receiving the output, or NULL to only measure.
+ *
+ * Return: The number of bytes the escaped body takes.
+ */
+static int json_escape(const char *s, int len, writer_t *out)
+{
+	static const char short_esc[0x20] = {
+		0, 0, 0, 0, 0, 0, 0, 0, 'b', 't', 'n', 0, 'f', 'r', 0, 0,
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+	char esc[6] = {'\\', 'u', '0', '0', 0, 0};
+	int i = 0, next, n, total = 0;
+	unsigned char c;
+
+	while (i < len)
+	{
+		next = json_scan(s, i, len);
+		if (out != NULL)
+			writer_write(out, s + i, next - i);
+		total += next - i;
+		if (next == len)
+			break;
+		c = (unsigned char)s[next];
+		n = 2;
+		esc[1] = c == '"' || c == '\\' ? (char)c : short_esc[c];
+		if (esc[1] == 0)
+		{
+			esc[1] = 'u', esc[4] = "0123456789abcdef"[c >> 4];
+			esc[5] = "0123456789abcdef"[c & 15], n = 6;
+		}
+		if (out != NULL)
+			writer_write(out, esc, n);
+		total += n;
+		i = next + 1;
+	}
+
+	return (total);
+}
+
+/**
+ * print_json - Print a string as a quoted JSON string.
+ *
+ * This function handles %J. The argument is written between double quotes
+ * with '"', '\\' and control bytes escaped, straight into the output
+ * buffer. A NULL pointer prints as null. Precision limits how many bytes
+ * of the argument are used, cutting before a UTF-8 sequence rather than
+ * inside it; width pads the quoted result.
+ *
+ * @types: A va_list containing the string.
+ * @out: The writer receiving the output.
+ * @spec: The parsed directive; precision is the most bytes of the argument
+ * to use, '-' left-justifies within the width.
+ *
+ * Return: The number of characters printed.
+ */
+int print_json(va_list types, writer_t *out, const spec_t *spec)
+{
+	const char *str = va_arg(types, const char *);
+	int len, full, pad = 0, flags = spec->flags;
+	spec_t null = *spec;
+
+	if (str == NULL)
+	{
+		null.precision = -1;
+		return (print_string_value("null", out, &null));
+	}
+
+	len = full = strlen(str);
+	if (spec->precision >= 0 && spec->precision < full)
+	{
+		len = spec->precision;
+		while (len > 0 && ((unsigned char)str[len] & 0xC0) == 0x80)
+			len--;
+	}
+	if (spec->width > 0)
+		pad = spec->width - json_escape(str, len, NULL) - 2;
+
+	if (!(flags & F_MINUS))
+		writer_pad(out, ' ', pad);
+	writer_write(out, "\"", 1);
+	len = json_escape(str, len, out);
+	writer_write(out, "\"", 1);
+	if (flags & F_MINUS)
+		writer_pad(out, ' ', pad);
+
+	return (len + 2 + (pad > 0 ? pad : 0));
+}
@@ -0,0 +1,27 @@
+#include "main.h"
+
+/*
+ * Lowest level the leveled front ends print at run time. It is read
+ * directly by PRINTF_LEVEL_OFF at every call site, so it stays a plain
+ * int that the compiler can load with a single instruction.
+ */
+int _printf_level = PRINTF_DEBUG;
+
+/**
+ * _printf_set_level - Choose the lowest level printed at run time.
+ *
+ * _printf_debug, _printf_info, _printf_warn and _printf_error calls below
+ * @level return at once, before their arguments are evaluated. Levels
+ * below PRINTF_MIN_LEVEL are compiled out whatever is set here.
+ *
+ * @level: PRINTF_DEBUG, PRINTF_INFO, PRINTF_WARN or PRINTF_ERROR.
+ *
+ * Return: The previous level, or -1 if @level is invalid.
+ */
+int _printf_set_level(int level)
+{
+	if (level < PRINTF_DEBUG || level > PRINTF_ERROR)
+		return (-1);
+
+	return (__atomic_exchange_n(&_printf_level, level, __ATOMIC_RELAXED));
+}
@@ -0,0 +1,175 @@
+#include "main.h"
+
+#define LZ_HASH_BITS 12
+#define LZ_MIN_MATCH 4
+/* The last bytes of a block are always literals, so matching may read ahead */
+#define LZ_TAIL 8
+
+/**
+ * lz_put_len - Write the extension bytes of a literal or match length.
+ *
+ * Lengths that do not fit in their 4-bit token field continue in bytes of
+ * 255 and a final byte below 255.
+ *
+ * @dst: The output.
+ * @o: Where the bytes go.
+ * @n: The length minus 15.
+ *
+ * Return: The new output position.
+ */
+static int lz_put_len(char *dst, int o, int n)
+{
+	for (; n >= 255; n -= 255)
+		dst[o++] = (char)255;
+	dst[o++] = (char)n;
+
+	return (o);
+}
+
+/**
+ * lz_sequence - Write one sequence: literals, then an optional match.
+ *
+ * A sequence is a token (literal length in the high nibble, match length
+ * minus LZ_MIN_MATCH in the low one, 15 meaning "more bytes follow"), the
+ * literal length extension, the literals, and for a match a 2-byte
+ * little-endian offset and the match length extension.
+ *
+ * @dst: The output.
+ * @o: Where the sequence goes.
+ * @lit: The literals.
+ * @nlit: The number of literals.
+ * @off: The distance back to the match, or 0 for none.
+ * @mlen: The match length (at least LZ_MIN_MATCH when @off is set).
+ *
+ * Return: The new output position.
+ */
+static int lz_sequence(char *dst, int o, const char *lit, int nlit,
+		int off, int mlen)
+{
+	int token = o++, m = off ? mlen - LZ_MIN_MATCH : 0;
+
+	dst[token] = (char)((nlit < 15 ? nlit : 15) << 4 | (m < 15 ? m : 15));
+	if (nlit >= 15)
+		o = lz_put_len(dst, o, nlit - 15);
+	memcpy(dst + o, lit, nlit);
+	o += nlit;
+	if (off == 0)
+		return (o);
+
+	dst[o++] = (char)(off & 0xFF);
+	dst[o++] = (char)(off >> 8);
+	if (m >= 15)
+		o = lz_put_len(dst, o, m - 15);
+
+	return (o);
+}
+
+/**
+ * lz_compress - Compress a block with a greedy LZ77 matcher.
+ *
+ * Each 4-byte sequence is looked up in a hash table of the last position
+ * it was seen at; a hit is extended as far as it goes and emitted as a
+ * match, everything else as literals. Runs without matches are skipped
+ * over faster the longer they get, so incompressible data costs little.
+ * The output needs at most LZ_BOUND(@n) bytes.
+ *
+ * @src: The block.
+ * @n: Its length.
+ * @dst: Receives the compressed block.
+ *
+ * Return: The compressed length.
+ */
+int lz_compress(const char *src, int n, char *dst)
+{
+	int table[1 << LZ_HASH_BITS], i = 0, anchor = 0, o = 0, ref, len;
+	unsigned int seq, h;
+
+	memset(table, 0xFF, sizeof(table));
+	while (i < n - LZ_TAIL - LZ_MIN_MATCH)
+	{
+		memcpy(&seq, src + i, 4);
+		h = seq * 2654435761U >> (32 - LZ_HASH_BITS);
+		ref = table[h];
+		table[h] = i;
+		if (ref < 0 || i - ref > 0xFFFF ||
+				memcmp(src + ref, src + i, LZ_MIN_MATCH) != 0)
+		{
+			i += 1 + ((i - anchor) >> 6);
+			continue;
+		}
+		for (len = LZ_MIN_MATCH; i + len < n - LZ_TAIL; len++)
+			if (src[ref + len] != src[i + len])
+				break;
+		o = lz_sequence(dst, o, src + anchor, i - anchor, i - ref, len);
+		i += len;
+		anchor = i;
+	}
+
+	return (lz_sequence(dst, o, src + anchor, n - anchor, 0, 0));
+}
+
+/**
+ * lz_get_len - Read the extension bytes of a literal or match length.
+ *
+ * @src: The compressed block.
+ * @i: Position of the first extension byte; advanced past the last.
+ * @n: The length of @src.
+ * @len: The length to add the extension to.
+ *
+ * Return: 0 on success, -1 if @src ends too early.
+ */
+static int lz_get_len(const unsigned char *src, int *i, int n, int *len)
+{
+	do {
+		if (*i >= n)
+			return (-1);
+		*len += src[*i];
+	} while (src[(*i)++] == 255);
+
+	return (0);
+}
+
+/**
+ * lz_decompress - Decompress a block made by lz_compress.
+ *
+ * Every length and offset is checked against both buffers, so a corrupt
+ * block makes this fail instead of reading or writing out of bounds.
+ *
+ * @src: The compressed block.
+ * @n: Its length.
+ * @dst: Receives the original bytes.
+ * @cap: The size of @dst.
+ *
+ * Return: The decompressed length, or -1 if the block is corrupt.
+ */
+int lz_decompress(const char *src, int n, char *dst, int cap)
+{
+	const unsigned char *s = (const unsigned char *)src;
+	int i = 0, o = 0, lit, mlen, off, ext;
+
+	while (i < n)
+	{
+		lit = s[i] >> 4, ext = s[i++] & 15;
+		mlen = ext + LZ_MIN_MATCH;
+		if (lit == 15 && lz_get_len(s, &i, n, &lit) == -1)
+			return (-1);
+		if (lit > n - i || lit > cap - o)
+			return (-1);
+		memcpy(dst + o, src + i, lit);
+		i += lit, o += lit;
+		if (i == n)
+			break;
+		if (i + 2 > n)
+			return (-1);
+		off = s[i] | s[i + 1] << 8;
+		i += 2;
+		if (ext == 15 && lz_get_len(s, &i, n, &mlen) == -1)
+			return (-1);
+		if (off == 0 || off > o || mlen > cap - o)
+			return (-1);
+		for (; mlen > 0; mlen--, o++)
+			dst[o] = dst[o - off];
+	}
+
+	return (o);
+}
@@ -0,0 +1,193 @@
+#include "main.h"
+#include <stdlib.h>
+
+/**
+ * lz_sink_block - Compress one block and write it as a frame.
+ *
+ * A frame is the original length and the stored length, both 4-byte
+ * little-endian, followed by the stored bytes. A block that does not
+ * shrink is stored as is, flagged by the top bit of the stored length.
+ *
+ * @sink: The sink.
+ * @src: The block.
+ * @n: Its length.
+ *
+ * Return: The frame size, or -1 if the write failed.
+ */
+static int lz_sink_block(lz_sink_t *sink, const char *src, int n)
+{
+	unsigned char *hdr = (unsigned char *)sink->packed;
+	unsigned long stored;
+	int len, i;
+
+	len = lz_compress(src, n, sink->packed + LZ_FRAME_HDR);
+	stored = len;
+	if (len >= n)
+	{
+		memcpy(sink->packed + LZ_FRAME_HDR, src, n);
+		len = n;
+		stored = n | 0x80000000UL;
+	}
+	for (i = 0; i < 4; i++)
+	{
+		hdr[i] = (unsigned long)n >> (i * 8) & 0xFF;
+		hdr[4 + i] = stored >> (i * 8) & 0xFF;
+	}
+	len += LZ_FRAME_HDR;
+
+	return (fd_send(sink->fd, sink->packed, len) == len ? len : -1);
+}
+
+/**
+ * lz_sink_worker - Background thread that compresses and writes blocks.
+ *
+ * @arg: The lz_sink_t.
+ *
+ * Return: NULL.
+ */
+static void *lz_sink_worker(void *arg)
+{
+	lz_sink_t *sink = arg;
+	int n, len, failed;
+
+	pthread_mutex_lock(&sink->lock);
+	while (1)
+	{
+		while (sink->pending == 0 && !sink->stop)
+			pthread_cond_wait(&sink->cond, &sink->lock);
+		n = sink->pending;
+		if (n == 0)
+			break;
+		failed = sink->error;
+		pthread_mutex_unlock(&sink->lock);
+		len = failed ? -1 : lz_sink_block(sink,
+				sink->raw + sink->full * LZ_SINK_BLOCK, n);
+		pthread_mutex_lock(&sink->lock);
+		if (len == -1)
+			sink->error = 1;
+		else
+			sink->raw_bytes += n, sink->packed_bytes += len;
+		sink->pending = 0;
+		pthread_cond_broadcast(&sink->cond);
+	}
+	pthread_mutex_unlock(&sink->lock);
+
+	return (NULL);
+}
+
+/**
+ * lz_sink_flush - Flush callback of compressing sinks.
+ *
+ * The full buffer is handed to the worker thread and the writer carries
+ * on in the other one, so formatting and compression overlap. This only
+ * waits when the worker is still busy with the previous block.
+ *
+ * @out: The sink's writer.
+ *
+ * Return: 0 on success, -1 if a write has failed.
+ */
+static int lz_sink_flush(writer_t *out)
+{
+	lz_sink_t *sink = out->ctx;
+
+	pthread_mutex_lock(&sink->lock);
+	while (sink->pending > 0)
+		pthread_cond_wait(&sink->cond, &sink->lock);
+	sink->full = sink->cur;
+	sink->pending = out->len;
+	sink->cur ^= 1;
+	pthread_cond_broadcast(&sink->cond);
+	if (sink->error)
+		out->error = 1;
+	pthread_mutex_unlock(&sink->lock);
+
+	out->buf = sink->raw + sink->cur * LZ_SINK_BLOCK;
+	out->len = 0;
+
+	return (out->error ? -1 : 0);
+}
+
+/**
+ * lz_sink_open - Set up compressed output to a file descriptor.
+ *
+ * Output is collected in blocks of LZ_SINK_BLOCK bytes, and each block is
+ * compressed with lz_compress and written as a frame by a background
+ * thread while the next block is being formatted. The stream starts with
+ * the magic "PFLZ" and a version byte and ends with an empty frame;
+ * tools/lz_cat.c turns it back into text. The descriptor should be
+ * blocking. Format into it with _wprintf(&sink->out, ...) from one thread.
+ *
+ * @sink: The sink to initialize.
+ * @fd: The destination file descriptor; it is not closed by the sink.
+ *
+ * Return: 0 on success, -1 on failure.
+ */
+int lz_sink_open(lz_sink_t *sink, int fd)
+{
+	sink->raw = malloc(2 * LZ_SINK_BLOCK);
+	sink->packed = malloc(LZ_FRAME_HDR + LZ_BOUND(LZ_SINK_BLOCK));
+	if (sink->raw == NULL || sink->packed == NULL ||
+			pthread_mutex_init(&sink->lock, NULL) != 0)
+	{
+		free(sink->raw);
+		free(sink->packed);
+		return (-1);
+	}
+
+	sink->fd = fd;
+	sink->cur = 0;
+	sink->pending = 0;
+	sink->stop = 0;
+	sink->error = 0;
+	sink->raw_bytes = 0;
+	sink->packed_bytes = LZ_MAGIC_LEN;
+	pthread_cond_init(&sink->cond, NULL);
+	writer_init(&sink->out, sink->raw, LZ_SINK_BLOCK, sink->scratch, fd);
+	sink->out.flush = lz_sink_flush;
+	sink->out.ctx = sink;
+	if (fd_send(fd, LZ_MAGIC, LZ_MAGIC_LEN) != LZ_MAGIC_LEN ||
+			pthread_create(&sink->thread, NULL,
+				lz_sink_worker, sink) != 0)
+	{
+		pthread_cond_destroy(&sink->cond);
+		pthread_mutex_destroy(&sink->lock);
+		free(sink->raw);
+		free(sink->packed);
+		return (-1);
+	}
+
+	return (0);
+}
+
+/**
+ * lz_sink_close - Flush a compressing sink, end the stream and release it.
+ *
+ * After this, @sink->raw_bytes and @sink->packed_bytes hold the totals
+ * before and after compression, from which the ratio follows.
+ *
+ * @sink: The sink to close.
+ *
+ * Return: 0 on success, -1 if any output was lost.
+ */
+int lz_sink_close(lz_sink_t *sink)
+{
+	static const char end[LZ_FRAME_HDR];
+
+	writer_flush(&sink->out);
+	pthread_mutex_lock(&sink->lock);
+	sink->stop = 1;
+	pthread_cond_broadcast(&sink->cond);
+	pthread_mutex_unlock(&sink->lock);
+	pthread_join(sink->thread, NULL);
+
+	if (!sink->error &&
+			fd_send(sink->fd, end, LZ_FRAME_HDR) != LZ_FRAME_HDR)
+		sink->error = 1;
+	sink->packed_bytes += LZ_FRAME_HDR;
+	pthread_cond_destroy(&sink->cond);
+	pthread_mutex_destroy(&sink->lock);
+	free(sink->raw);
+	free(sink->packed);
+
+	return (sink->error || sink->out.error ? -1 : 0);
+}
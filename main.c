@@ -38,7 +38,7 @@ int main(void)
 	len2 = printf("Percent:[%%]\n");
 	_printf("Len:[%d]\n", len);
 	printf("Len:[%d]\n", len2);
-	_printf("Unknown:[%r]\n");
-	printf("Unknown:[%r]\n");
+	_printf("Reverse:[%r]\n", "Hello");
+	printf("Reverse:[%s]\n", "olleH");
 	return (0);
 }
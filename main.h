@@ -4,10 +4,206 @@
 /****** LIBRARY INCLUDED *****/
 #include <stdarg.h>
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
+#include <wchar.h>
+#include <pthread.h>
+#include <sys/types.h>
 
 #define UNUSED(x) (void)(x)
+
+/*
+ * BUFF_SIZE sizes the staging buffer and the conversion scratch space
+ * that _printf keeps on the stack. Build with -DBUFF_SIZE=64 for small
+ * thread or coroutine stacks: no conversion needs more scratch than the
+ * 64 digits of a %lb, and padding, precision zeros and string bodies are
+ * streamed through the writer in buffer-sized chunks.
+ *
+ * Stack bound per call, measured on x86-64 at -O2 with eager binding:
+ * _printf and _printf_ct hold a buffer and a scratch area of BUFF_SIZE
+ * each, and a third when a dedup summary line is written from inside a
+ * flush, so they need at most 3 * BUFF_SIZE + 2 KB (2.2 KB with
+ * -DBUFF_SIZE=64, 5 KB at the default). _printf_sigsafe needs
+ * 2 * BUFF_SIZE + 1 KB and _asprintf BUFF_SIZE + 1 KB. Lazy PLT binding
+ * adds a few KB once, on the first call into each libc function.
+ */
+#ifndef BUFF_SIZE
 #define BUFF_SIZE 1024
+#endif
+#if BUFF_SIZE < 64
+#error "BUFF_SIZE must be at least 64"
+#endif
+
+/***** SINKS *****/
+#ifndef FD_SINK_QUEUE
+#define FD_SINK_QUEUE (64 * 1024)
+#endif
+#define FD_SINK_DROP_NEW 0
+#define FD_SINK_DROP_OLD 1
+#define FD_SINK_WAIT 2
+/* Longest stall, in ms, the stdout sink waits out when draining at exit */
+#ifndef FD_SINK_EXIT_WAIT
+#define FD_SINK_EXIT_WAIT 1000
+#endif
+
+#ifndef MMAP_SINK_CHUNK
+#define MMAP_SINK_CHUNK (16 * 1024 * 1024)
+#endif
+
+#ifndef URING_SINK_BUFS
+#define URING_SINK_BUFS 8
+#endif
+#ifndef URING_SINK_BUF_SIZE
+#define URING_SINK_BUF_SIZE (64 * 1024)
+#endif
+#ifndef URING_SINK_BATCH
+#define URING_SINK_BATCH 4
+#endif
+
+#ifndef LZ_SINK_BLOCK
+#define LZ_SINK_BLOCK (64 * 1024)
+#endif
+/* Worst-case size of an n-byte block after lz_compress */
+#define LZ_BOUND(n) ((n) + (n) / 255 + 16)
+#define LZ_FRAME_HDR 8
+#define LZ_MAGIC "PFLZ\001"
+#define LZ_MAGIC_LEN 5
+
+#ifndef TEE_SINKS
+#define TEE_SINKS 8
+#endif
+
+#ifndef DIRECT_SINK_BUF
+#define DIRECT_SINK_BUF (1024 * 1024)
+#endif
+/* Block size used when the file system does not report a usable one */
+#ifndef DIRECT_SINK_ALIGN
+#define DIRECT_SINK_ALIGN 4096
+#endif
+
+/***** BATCHES *****/
+#ifndef BATCH_SIZE
+#define BATCH_SIZE (16 * 1024)
+#endif
+#ifndef BATCH_RECORDS
+#define BATCH_RECORDS 64
+#endif
+
+/***** PARALLEL BATCHES *****/
+#ifndef PAR_CHUNK
+#define PAR_CHUNK 1024
+#endif
+#ifndef PAR_THREADS
+#define PAR_THREADS 64
+#endif
+#ifndef PAR_BUF_SIZE
+#define PAR_BUF_SIZE (64 * 1024)
+#endif
+
+/***** CAPTURE *****/
+#ifndef CAPTURE_FORMATS
+#define CAPTURE_FORMATS 1024
+#endif
+#ifndef CAPTURE_BUF_SIZE
+#define CAPTURE_BUF_SIZE (64 * 1024)
+#endif
+#define CAPTURE_MAGIC "PFTR\001"
+#define CAPTURE_MAGIC_LEN 5
+/* Trace records */
+#define CAP_FORMAT 'F'
+#define CAP_CALL 'C'
+#define CAP_END 'E'
+/* Arguments of a CAP_CALL record */
+#define CAP_WORD 'W'
+#define CAP_STR 'S'
+#define CAP_WIDE 'L'
+#define CAP_ARRAY 'A'
+#define CAP_NULL 'N'
+/* Ends the arguments of a call that reached a registered conversion */
+#define CAP_CUSTOM 'R'
+
+/***** WIDTH MODES *****/
+#define WIDTH_BYTES 0
+#define WIDTH_CODEPOINTS 1
+#define WIDTH_COLUMNS 2
+
+/***** RATE LIMITING *****/
+#define RATE_OFF 0
+#define RATE_LIMIT 1
+#define RATE_SAMPLE 2
+#ifndef RATE_SITES
+#define RATE_SITES 1024
+#endif
+#if RATE_SITES <= 0 || (RATE_SITES & (RATE_SITES - 1))
+#error "RATE_SITES must be a power of two"
+#endif
+#ifndef RATE_REPORT_SEC
+#define RATE_REPORT_SEC 10
+#endif
+
+/***** LOG LEVELS *****/
+#define PRINTF_DEBUG 0
+#define PRINTF_INFO 1
+#define PRINTF_WARN 2
+#define PRINTF_ERROR 3
+#ifndef PRINTF_MIN_LEVEL
+#define PRINTF_MIN_LEVEL PRINTF_DEBUG
+#endif
+
+/*
+ * The leveled front ends expand to "switch (off) case 0: _printf", so
+ * their argument list becomes the argument list of _printf. A level below
+ * PRINTF_MIN_LEVEL makes the condition a constant and the compiler drops
+ * the whole call, arguments included. Otherwise the only cost of a
+ * disabled call is one compare and branch on _printf_level. A switch
+ * rather than an if leaves no else of its own, so a call that is the
+ * body of an unbraced if neither captures the caller's else nor draws
+ * -Wdangling-else.
+ */
+#define PRINTF_LEVEL_OFF(level) \
+	((level) < PRINTF_MIN_LEVEL || (level) < _printf_level)
+#define _printf_debug switch (PRINTF_LEVEL_OFF(PRINTF_DEBUG)) case 0: _printf
+#define _printf_info switch (PRINTF_LEVEL_OFF(PRINTF_INFO)) case 0: _printf
+#define _printf_warn switch (PRINTF_LEVEL_OFF(PRINTF_WARN)) case 0: _printf
+#define _printf_error switch (PRINTF_LEVEL_OFF(PRINTF_ERROR)) case 0: _printf
+
+/***** TIMESTAMP CONVERSION *****/
+#define TIME_PREFIX_LEN 19
+
+/***** ARRAY CONVERSION *****/
+#define ARRAY_BATCH 8
+#define ARRAY_SLOT 24
+
+/***** PROFILING *****/
+#define PROF_PARSE 0
+#define PROF_CONVERT 1
+#define PROF_FLUSH 2
+#define PROF_PHASES 3
+#define PROF_BUCKETS 32
+
+/*
+ * PROF_VAR must be the last declaration of its block. Without
+ * PRINTF_PROFILE the macros expand to nothing. Time is measured on a
+ * per-writer clock that stands still while the writer flushes: PROF_PAUSE
+ * ends a flush by adding its time to @out->prof_flush, so a conversion
+ * that flushes part way is not charged for it and the phases add up to
+ * the total. PROF_END records nothing for signal-safe writers, since
+ * prof_record is not safe.
+ */
+#ifdef PRINTF_PROFILE
+#define PROF_VAR(t) unsigned long t
+#define PROF_START(out, t) ((t) = prof_now() - (out)->prof_flush)
+#define PROF_END(out, phase, spec, t, bytes) \
+	((out)->safe ? (void)0 : prof_record(phase, spec, \
+		prof_now() - (out)->prof_flush - (t), bytes))
+#define PROF_PAUSE(out, t) \
+	((out)->prof_flush = prof_now() - (t))
+#else
+#define PROF_VAR(t)
+#define PROF_START(out, t)
+#define PROF_END(out, phase, spec, t, bytes)
+#define PROF_PAUSE(out, t)
+#endif
 
 /***** FLAGS *****/
 #define F_MINUS 1
@@ -20,74 +216,521 @@
 #define S_LONG 2
 #define S_SHORT 1
 
+/**
+ * struct writer - Output handle used by _printf and every converter.
+ * @buf: Staging buffer that converters append to.
+ * @cap: Capacity of @buf in bytes.
+ * @len: Number of bytes currently pending in @buf.
+ * @error: Set once the sink has failed; later output is discarded.
+ * @flush: Sink callback, consumes buf[0..len) and resets @len.
+ * @fd: Destination file descriptor for fd sinks.
+ * @ctx: Sink-specific state for other sinks.
+ * @scratch: BUFF_SIZE bytes converters may use to build digits.
+ * @hashing: Non-zero to hash everything written (see writer_hash).
+ * @hash_len: Number of bytes hashed.
+ * @hash: Running hash of the whole 8-byte words written.
+ * @hash_tail: The bytes after the last whole word.
+ * @safe: Non-zero to allow only the async-signal-safe built-in conversions
+ * (see _vdprintf_sigsafe).
+ * @prof_flush: Time spent in flushes, in prof_now units, kept by
+ * PRINTF_PROFILE builds so it can be left out of conversion times.
+ */
+typedef struct writer
+{
+	char *buf;
+	int cap;
+	int len;
+	int error;
+	int (*flush)(struct writer *out);
+	int fd;
+	void *ctx;
+	char *scratch;
+	int hashing;
+	int hash_len;
+	unsigned long hash;
+	unsigned long hash_tail;
+	int safe;
+	unsigned long prof_flush;
+} writer_t;
+
+/**
+ * struct spec - One parsed conversion directive.
+ * @width: Minimum field width, 0 when absent.
+ * @precision: Precision, -1 when absent.
+ * @flags: F_* flags.
+ * @size: S_LONG, S_SHORT or 0.
+ * @conv: The conversion character.
+ */
+typedef struct spec
+{
+	int width;
+	int precision;
+	unsigned char flags;
+	unsigned char size;
+	char conv;
+} spec_t;
+
+/*
+ * conv_fn - Conversion handler, built-in or registered with
+ * _printf_register(). It takes its argument from the va_list, formats it
+ * as the directive @spec says, writes through the writer and returns the
+ * number of characters produced, or -1 on error.
+ */
+typedef int (*conv_fn)(va_list types, writer_t *out, const spec_t *spec);
+
+/*
+ * par_fn - Formats one record for par_format, typically with a single
+ * _wprintf(out, format, record->field, ...) call, and returns the number
+ * of characters produced or -1 on error.
+ */
+typedef int (*par_fn)(writer_t *out, const void *record);
+
 struct fmt
 {
 	char fmt;
-	int (*fn)(va_list, char[], int, int, int, int);
+	conv_fn fn;
 };
 
 typedef struct fmt fmt_t;
 
+/**
+ * struct arena - Bump-pointer arena that _asprintf formats into.
+ * @base: The caller's memory.
+ * @cap: Size of @base.
+ * @used: Bytes handed out since the last reset.
+ */
+typedef struct arena
+{
+	char *base;
+	size_t cap;
+	size_t used;
+} arena_t;
+
+/**
+ * struct batch - Records formatted together and written in one go.
+ * @out: The writer the records are formatted into.
+ * @count: Number of records added since the last commit.
+ * @total: Total length of those records.
+ * @lens: Length of each of the first BATCH_RECORDS records.
+ * @flushes: Number of times @out has been written out.
+ * @sink: The shared stdout sink for standard output, NULL otherwise.
+ * @buffer: Staging buffer of @out.
+ * @scratch: Conversion scratch space for @out.
+ */
+typedef struct batch
+{
+	writer_t out;
+	int count;
+	int total;
+	int lens[BATCH_RECORDS];
+	int flushes;
+	struct fd_sink *sink;
+	char buffer[BATCH_SIZE];
+	char scratch[BUFF_SIZE];
+} batch_t;
+
+/**
+ * struct fd_sink - Output to a possibly non-blocking file descriptor.
+ * @out: A writer to format into, for use by a single thread.
+ * @fd: The destination file descriptor.
+ * @policy: What to do when @queue is full (FD_SINK_DROP_NEW,
+ * FD_SINK_DROP_OLD or FD_SINK_WAIT).
+ * @timeout: Longest wait in milliseconds for FD_SINK_WAIT.
+ * @error: Set once the descriptor has failed.
+ * @head: Offset of the oldest pending byte in @queue.
+ * @queued: Number of bytes pending in @queue.
+ * @dropped: Number of bytes discarded because @queue was full.
+ * @dedup: Seconds a run of repeated messages is held, 0 if not held.
+ * @prev_len: Length of the previous message, -1 if unknown.
+ * @run_start: Monotonic second at which the current run began.
+ * @prev_hash: Hash of the previous message.
+ * @repeats: Repeats of the previous message held back so far.
+ * @lock: Serializes flushes from several writers.
+ * @queue: Ring of bytes the descriptor could not take yet.
+ * @buffer: Staging buffer of @out.
+ * @scratch: Conversion scratch space for @out.
+ */
+typedef struct fd_sink
+{
+	writer_t out;
+	int fd;
+	int policy;
+	int timeout;
+	int error;
+	int head;
+	int queued;
+	unsigned long dropped;
+	int dedup;
+	int prev_len;
+	long run_start;
+	unsigned long prev_hash;
+	unsigned long repeats;
+	pthread_mutex_t lock;
+	char queue[FD_SINK_QUEUE];
+	char buffer[BUFF_SIZE];
+	char scratch[BUFF_SIZE];
+} fd_sink_t;
+
+/**
+ * struct lz_sink - Output compressed in blocks by a background thread.
+ * @out: The writer to format into; its buffer is one half of @raw.
+ * @fd: The destination file descriptor.
+ * @cur: The half of @raw the writer is filling.
+ * @full: The half of @raw handed to the worker.
+ * @pending: Bytes in the @full half waiting for the worker, 0 if none.
+ * @stop: Set when the worker should exit once idle.
+ * @error: Set once a write has failed.
+ * @raw_bytes: Total bytes compressed.
+ * @packed_bytes: Total bytes written, framing included.
+ * @thread: The worker thread.
+ * @lock: Protects the fields shared with the worker.
+ * @cond: Signals a new block for, or a finished one from, the worker.
+ * @raw: Two blocks of LZ_SINK_BLOCK bytes.
+ * @packed: The frame being written.
+ * @scratch: Conversion scratch space for @out.
+ */
+typedef struct lz_sink
+{
+	writer_t out;
+	int fd;
+	int cur;
+	int full;
+	int pending;
+	int stop;
+	int error;
+	unsigned long raw_bytes;
+	unsigned long packed_bytes;
+	pthread_t thread;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	char *raw;
+	char *packed;
+	char scratch[BUFF_SIZE];
+} lz_sink_t;
+
+/**
+ * struct tee_sink - Output formatted once and copied to several writers.
+ * @out: The writer to format into.
+ * @count: Number of destinations in @to.
+ * @to: The destination writers, each with its own buffer and sink.
+ * @sync: For each destination, non-zero to flush it at every commit.
+ * @buffer: Staging buffer of @out.
+ * @scratch: Conversion scratch space for @out.
+ */
+typedef struct tee_sink
+{
+	writer_t out;
+	int count;
+	writer_t *to[TEE_SINKS];
+	char sync[TEE_SINKS];
+	char buffer[BUFF_SIZE];
+	char scratch[BUFF_SIZE];
+} tee_sink_t;
+
+/**
+ * struct mem_sink - Output collected in caller memory.
+ * @out: The writer to format into; its buffer is the caller's memory.
+ * @scratch: Conversion scratch space for @out.
+ */
+typedef struct mem_sink
+{
+	writer_t out;
+	char scratch[BUFF_SIZE];
+} mem_sink_t;
+
+/**
+ * struct callback_sink - Output handed to a function in chunks.
+ * @out: The writer to format into.
+ * @fn: Receives each chunk; returns -1 to mark the sink failed.
+ * @arg: First argument of @fn.
+ * @buffer: Staging buffer of @out.
+ * @scratch: Conversion scratch space for @out.
+ */
+typedef struct callback_sink
+{
+	writer_t out;
+	int (*fn)(void *arg, const char *s, int n);
+	void *arg;
+	char buffer[BUFF_SIZE];
+	char scratch[BUFF_SIZE];
+} callback_sink_t;
+
+/**
+ * struct prof_stat - Profile counters of one phase and conversion.
+ * @count: Number of timed calls.
+ * @cycles: Total time, in prof_now units.
+ * @bytes: Total bytes produced.
+ * @hist: Calls per power-of-two time bucket.
+ */
+typedef struct prof_stat
+{
+	unsigned long count;
+	unsigned long cycles;
+	unsigned long bytes;
+	unsigned long hist[PROF_BUCKETS];
+} prof_stat_t;
+
+/**
+ * struct mmap_sink - Log file written through a sliding shared mapping.
+ * @out: The writer to format into; its buffer points into @map.
+ * @fd: The log file.
+ * @map: The current window of MMAP_SINK_CHUNK bytes.
+ * @map_start: File offset of @map.
+ * @tail: File offset just past the committed output.
+ * @size: Current size of the file, including the unused mapped part.
+ * @scratch: Conversion scratch space for @out.
+ */
+typedef struct mmap_sink
+{
+	writer_t out;
+	int fd;
+	char *map;
+	off_t map_start;
+	off_t tail;
+	off_t size;
+	char scratch[BUFF_SIZE];
+} mmap_sink_t;
+
+/**
+ * struct direct_sink - Log file written with O_DIRECT in aligned blocks.
+ * @out: The writer to format into; its buffer is aligned to @align.
+ * @fd: The log file.
+ * @direct: Non-zero while the file is open with O_DIRECT, 0 once it has
+ * fallen back to buffered I/O.
+ * @align: The block size every write is aligned to.
+ * @offset: File offset of the start of @out's buffer, a multiple of @align.
+ * @scratch: Conversion scratch space for @out.
+ */
+typedef struct direct_sink
+{
+	writer_t out;
+	int fd;
+	int direct;
+	int align;
+	off_t offset;
+	char scratch[BUFF_SIZE];
+} direct_sink_t;
+
+/**
+ * struct uring - io_uring state behind a uring_sink_t.
+ * @ring_fd: The io_uring descriptor, -1 when io_uring is not in use.
+ * @sq_tail: Submission ring tail.
+ * @sq_mask: Submission ring index mask.
+ * @sq_array: Submission ring slot array.
+ * @cq_head: Completion ring head.
+ * @cq_tail: Completion ring tail.
+ * @cq_mask: Completion ring index mask.
+ * @sqes: The submission entries.
+ * @cqes: The completion entries.
+ * @sq_map: Mapping of the submission ring.
+ * @cq_map: Mapping of the completion ring (may equal @sq_map).
+ * @sq_size: Size of @sq_map.
+ * @cq_size: Size of @cq_map.
+ * @sqe_size: Size of the @sqes mapping.
+ * @fixed: Non-zero when the buffers are registered with the kernel.
+ * @queued: Entries published but not yet submitted.
+ * @pending: Entries published whose completion has not been reaped yet;
+ * the kernel may still be using their buffers.
+ */
+typedef struct uring
+{
+	int ring_fd;
+	unsigned int *sq_tail, *sq_mask, *sq_array;
+	unsigned int *cq_head, *cq_tail, *cq_mask;
+	void *sqes, *cqes;
+	void *sq_map, *cq_map;
+	size_t sq_size, cq_size, sqe_size;
+	int fixed;
+	int queued;
+	int pending;
+} uring_t;
+
+/**
+ * struct uring_sink - Batched asynchronous output over an io_uring.
+ * @out: The writer to format into; its buffer is one of @bufs.
+ * @fd: The destination file descriptor.
+ * @cur: Index of the buffer being formatted into.
+ * @inflight: Number of buffers queued or in flight.
+ * @offset: Next file offset for files, -1 for streams.
+ * @bufs: URING_SINK_BUFS buffers of URING_SINK_BUF_SIZE bytes.
+ * @lens: Bytes held by each buffer, 0 when the buffer is free.
+ * @done: Bytes of each buffer the kernel has written so far.
+ * @offs: File offset of each buffer, -1 for streams.
+ * @ring: The io_uring.
+ * @scratch: Conversion scratch space for @out.
+ */
+typedef struct uring_sink
+{
+	writer_t out;
+	int fd;
+	int cur;
+	int inflight;
+	off_t offset;
+	char *bufs;
+	int lens[URING_SINK_BUFS];
+	int done[URING_SINK_BUFS];
+	off_t offs[URING_SINK_BUFS];
+	uring_t ring;
+	char scratch[BUFF_SIZE];
+} uring_sink_t;
+
 int _printf(const char *format, ...);
+int _wprintf(writer_t *out, const char *format, ...);
+int _vwprintf(writer_t *out, const char *format, va_list list);
+int _printf_sigsafe(const char *format, ...);
+int _dprintf_sigsafe(int fd, char *buf, int size, const char *format, ...);
+int _vdprintf_sigsafe(int fd, char *buf, int size, const char *format,
+		va_list list);
+int _asprintf(arena_t *arena, char **strp, const char *format, ...);
+int _vasprintf(arena_t *arena, char **strp, const char *format, va_list list);
+void batch_init(batch_t *batch, int fd);
+int batch_add(batch_t *batch, const char *format, ...);
+int _vbatch_add(batch_t *batch, const char *format, va_list list);
+int batch_commit(batch_t *batch);
+long par_format(int fd, const void *records, size_t size, long count,
+		par_fn fn, int threads);
+void arena_init(arena_t *arena, char *mem, size_t size);
+void arena_reset(arena_t *arena);
+int _printf_set_rate(int mode, unsigned long n, unsigned long burst);
+extern int _printf_level;
+int _printf_set_level(int level);
+extern int _printf_capture_on;
+int _printf_capture(int fd);
+void capture_call(const char *format, va_list list);
+void capture_callf(const char *format, ...);
+void capture_args(writer_t *out, const char *format, va_list list);
+void capture_varint(writer_t *out, unsigned long v);
+void capture_bytes(writer_t *out, char tag, const void *p, long n);
+int rate_admit(const char *format);
+int rate_report(writer_t *out);
+void parse_spec(const char *format, int *i, va_list list, spec_t *spec);
 int handle_print(const char *fmt, int *i,
-		 va_list list, char buffer[], int flags,
-		 int width, int precision, int size);
+		 va_list list, writer_t *out, const spec_t *spec);
+
+/***** WRITER *****/
+void writer_init(writer_t *out, char *buf, int cap, char *scratch, int fd);
+int writer_write(writer_t *out, const char *s, int n);
+int writer_pad(writer_t *out, char c, int n);
+int writer_flush(writer_t *out);
+void writer_hash(writer_t *out, const char *s, int n);
+int print_buffer(writer_t *out);
+int fd_send(int fd, const char *buf, int len);
+int fd_sink_open(fd_sink_t *sink, int fd, int policy, int timeout);
+void fd_sink_set_policy(fd_sink_t *sink, int policy, int timeout);
+int fd_sink_flush(writer_t *out);
+void fd_sink_put(fd_sink_t *sink, const char *s, int n);
+void fd_sink_set_dedup(fd_sink_t *sink, int seconds);
+void fd_sink_repeats(fd_sink_t *sink);
+void fd_sink_repeats_due(fd_sink_t *sink, long now);
+int fd_sink_commit(writer_t *out);
+int fd_sink_drain(fd_sink_t *sink);
+int fd_sink_finish(fd_sink_t *sink, int timeout);
+unsigned long fd_sink_dropped(fd_sink_t *sink);
+int fd_sink_close(fd_sink_t *sink);
+fd_sink_t *fd_sink_stdout(void);
+int stdout_begin(writer_t *out, char *buffer, char *scratch,
+		const char *format);
+int mmap_sink_open(mmap_sink_t *sink, const char *path);
+int mmap_sink_close(mmap_sink_t *sink);
+int direct_sink_open(direct_sink_t *sink, const char *path);
+int direct_sink_close(direct_sink_t *sink);
+long direct_io_read(direct_sink_t *sink, char *buf, long n, off_t off);
+int direct_io_write(direct_sink_t *sink, const char *buf, long n, off_t off);
+int lz_sink_open(lz_sink_t *sink, int fd);
+int lz_sink_close(lz_sink_t *sink);
+int lz_compress(const char *src, int n, char *dst);
+int lz_decompress(const char *src, int n, char *dst, int cap);
+void tee_sink_open(tee_sink_t *tee);
+int tee_sink_add(tee_sink_t *tee, writer_t *to, int sync);
+int tee_sink_commit(tee_sink_t *tee);
+void mem_sink_open(mem_sink_t *sink, char *mem, int size);
+void callback_sink_open(callback_sink_t *sink,
+		int (*fn)(void *arg, const char *s, int n), void *arg);
+int uring_sink_open(uring_sink_t *sink, int fd);
+int uring_sink_close(uring_sink_t *sink);
+int uring_ring_setup(uring_t *r, unsigned int entries,
+		char *bufs, int nbufs, int bufsize);
+void uring_ring_queue(uring_t *r, int fd, int index, char *buf, int len,
+		off_t off);
+int uring_ring_submit(uring_t *r, int wait);
+int uring_ring_reap(uring_t *r, int *index, int *res);
+int uring_ring_free(uring_t *r);
+
+/***** PROFILING *****/
+unsigned long prof_now(void);
+void prof_record(int phase, char spec, unsigned long cycles, int bytes);
+void prof_dump(void);
+
+/***** DISPATCH *****/
+conv_fn dispatch_lookup(char spec);
+conv_fn dispatch_lookup_safe(char spec);
+int _printf_register(char spec, conv_fn handler);
 
 /***** FUNCTIONS *****/
 
-int print_char(va_list types, char buffer[],
-			   int flags, int width, int precision, int size);
-int print_string(va_list types, char buffer[],
-				 int flags, int width, int precision, int size);
-int print_percent(va_list types, char buffer[],
-				  int flags, int width, int precision, int size);
-
-int print_int(va_list types, char buffer[],
-			  int flags, int width, int precision, int size);
-int print_binary(va_list types, char buffer[],
-				 int flags, int width, int precision, int size);
-int print_unsigned(va_list types, char buffer[],
-				   int flags, int width, int precision, int size);
-int print_octal(va_list types, char buffer[],
-				int flags, int width, int precision, int size);
-int print_hexadecimal(va_list types, char buffer[],
-					  int flags, int width, int precision, int size);
-int print_hexa_upper(va_list types, char buffer[],
-					 int flags, int width, int precision, int size);
+int print_char(va_list types, writer_t *out, const spec_t *spec);
+int print_string(va_list types, writer_t *out, const spec_t *spec);
+int print_percent(va_list types, writer_t *out, const spec_t *spec);
+
+int print_int(va_list types, writer_t *out, const spec_t *spec);
+int print_binary(va_list types, writer_t *out, const spec_t *spec);
+int print_unsigned(va_list types, writer_t *out, const spec_t *spec);
+int print_octal(va_list types, writer_t *out, const spec_t *spec);
+int print_hexadecimal(va_list types, writer_t *out, const spec_t *spec);
+int print_hexa_upper(va_list types, writer_t *out, const spec_t *spec);
 
 int print_hexa(va_list types, char map_to[],
-		char buffer[], int flags, char flag_ch,
-		int width, int precision, int size);
+		writer_t *out, const spec_t *spec, char flag_ch);
 
-int print_non_printable(va_list types, char buffer[],
-						int flags, int width, int precision, int size);
+int print_non_printable(va_list types, writer_t *out, const spec_t *spec);
 
-int print_pointer(va_list types, char buffer[],
-				  int flags, int width, int precision, int size);
+int print_pointer(va_list types, writer_t *out, const spec_t *spec);
 
-int get_flags(const char *format, int *i);
-int get_width(const char *format, int *i, va_list list);
-int get_precision(const char *format, int *i, va_list list);
-int get_size(const char *format, int *i);
+int print_json(va_list types, writer_t *out, const spec_t *spec);
+int print_fixed(va_list types, writer_t *out, const spec_t *spec);
+int print_time(va_list types, writer_t *out, const spec_t *spec);
 
-int print_reverse(va_list types, char buffer[],
-				  int flags, int width, int precision, int size);
+int print_reverse(va_list types, writer_t *out, const spec_t *spec);
 
-int print_rot13string(va_list types, char buffer[],
-					  int flags, int width, int precision, int size);
+int print_rot13string(va_list types, writer_t *out, const spec_t *spec);
 
-int handle_write_char(char c, char buffer[],
-					  int flags, int width, int precision, int size);
-int write_number(int is_positive, int ind, char buffer[],
-				 int flags, int width, int precision, int size);
-int write_num(int ind, char bff[], int flags, int width, int precision,
+int handle_write_char(char c, writer_t *out, const spec_t *spec);
+int write_number(int is_positive, int ind, writer_t *out,
+				 const spec_t *spec);
+int write_num(int ind, writer_t *out, int flags, int width, int precision,
 			  int length, char padd, char extra_c);
-int write_pointer(char buffer[], int ind, int length,
-				  int width, int flags, char padd, char extra_c, int padd_start);
+int write_digits(writer_t *out, const char *digits, int n,
+		const char *prefix, char sign, const spec_t *spec);
+
+/***** VALUE CONVERTERS (no va_list) *****/
+int print_int_value(long int n, writer_t *out, const spec_t *spec);
+int print_fixed_value(long int n, writer_t *out, const spec_t *spec);
+int print_unsigned_value(unsigned long int num, int base,
+		const char map_to[], char flag_ch, writer_t *out,
+		const spec_t *spec);
+int print_string_value(const char *str, writer_t *out, const spec_t *spec);
+int print_pointer_value(const void *addrs, writer_t *out,
+		const spec_t *spec);
+int print_radix_value(unsigned long num, int shift, const char *map_to,
+		const char *prefix, char sign, writer_t *out, const spec_t *spec);
+
+int print_wide_value(const wchar_t *ws, writer_t *out, const spec_t *spec);
+int print_wide_char(wint_t c, writer_t *out, const spec_t *spec);
+int print_utf8_value(const char *str, int len, writer_t *out,
+		const spec_t *spec);
+
+int print_array(const char *fmt, int *ind, va_list list, writer_t *out,
+		const spec_t *spec);
+void array_kernel(char conv, const unsigned long *mag, int n,
+		char slots[][ARRAY_SLOT], int lens[]);
+void hex16_sse2(unsigned long v, char *dst, int upper);
 
-int write_unsgnd(int is_negative, int ind,
-				 char buffer[],
-				 int flags, int width, int precision, int size);
+/***** UTF-8 *****/
+int _printf_set_width_mode(int mode);
+int utf8_width_mode(void);
+int utf8_units(unsigned int cp, int mode);
+int utf8_encode(unsigned int cp, char *dst);
+int utf8_ascii_len(const char *s, int *is_ascii);
 
 /***** UTILS *****/
 int is_printable(char);
@@ -0,0 +1,75 @@
+#include "main.h"
+
+/**
+ * mem_sink_full - Flush callback of memory sinks.
+ *
+ * The writer's buffer is all the memory there is, so needing a flush
+ * means the output does not fit.
+ *
+ * @out: The writer.
+ *
+ * Return: Always -1.
+ */
+static int mem_sink_full(writer_t *out)
+{
+	out->error = 1;
+
+	return (-1);
+}
+
+/**
+ * mem_sink_open - Set up output collected in caller memory.
+ *
+ * The output is @sink->out.buf[0..@sink->out.len), not NUL-terminated.
+ * Output that does not fit marks the sink failed and is dropped. Set
+ * @sink->out.len back to 0 to reuse the memory.
+ *
+ * @sink: The sink to initialize.
+ * @mem: The memory to collect output in.
+ * @size: The size of @mem.
+ */
+void mem_sink_open(mem_sink_t *sink, char *mem, int size)
+{
+	writer_init(&sink->out, mem, size, sink->scratch, -1);
+	sink->out.flush = mem_sink_full;
+}
+
+/**
+ * callback_sink_flush - Flush callback of callback sinks.
+ *
+ * @out: The writer.
+ *
+ * Return: 0 on success, -1 if the callback reported a failure.
+ */
+static int callback_sink_flush(writer_t *out)
+{
+	callback_sink_t *sink = out->ctx;
+
+	if (sink->fn(sink->arg, out->buf, out->len) == -1)
+		out->error = 1;
+	out->len = 0;
+
+	return (out->error ? -1 : 0);
+}
+
+/**
+ * callback_sink_open - Set up output handed to a function.
+ *
+ * The output is staged in BUFF_SIZE bytes and passed to @fn whenever that
+ * fills up and on every writer_flush, so @fn sees it in order but split
+ * at arbitrary points.
+ *
+ * @sink: The sink to initialize.
+ * @fn: Called as fn(@arg, bytes, length); returns -1 on failure, after
+ * which the sink drops its output.
+ * @arg: Passed through to @fn.
+ */
+void callback_sink_open(callback_sink_t *sink,
+		int (*fn)(void *arg, const char *s, int n), void *arg)
+{
+	writer_init(&sink->out, sink->buffer, BUFF_SIZE, sink->scratch, -1);
+	sink->out.flush = callback_sink_flush;
+	sink->out.ctx = sink;
+	sink->fn = fn;
+	sink->arg = arg;
+}
@@ -0,0 +1,162 @@
+#include "main.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/**
+ * mmap_sink_fail - Mark an mmap sink's writer as failed.
+ *
+ * The writer is left with no buffer, so later output is dropped instead
+ * of touching a mapping that no longer exists.
+ *
+ * @sink: The failed sink.
+ *
+ * Return: Always -1.
+ */
+static int mmap_sink_fail(mmap_sink_t *sink)
+{
+	sink->out.error = 1;
+	sink->out.buf = NULL;
+	sink->out.cap = 0;
+	sink->out.len = 0;
+
+	return (-1);
+}
+
+/**
+ * mmap_sink_map - Map the window of the log file that starts at the tail.
+ *
+ * The window begins at the page holding the tail and is MMAP_SINK_CHUNK
+ * bytes long. Disk space for the whole window is allocated first with
+ * posix_fallocate, extending the file if needed: a sparse extension would
+ * turn a full file system into a SIGBUS on the first store instead of an
+ * error here. The writer is pointed at the tail inside the new mapping,
+ * so converters format straight into the file's pages.
+ *
+ * @sink: The sink to remap.
+ *
+ * Return: 0 on success, -1 on failure (the writer is marked failed).
+ */
+static int mmap_sink_map(mmap_sink_t *sink)
+{
+	off_t start = sink->tail & ~((off_t)sysconf(_SC_PAGESIZE) - 1);
+	void *map;
+
+	if (sink->map != NULL)
+		munmap(sink->map, MMAP_SINK_CHUNK);
+	sink->map = NULL;
+
+	if (posix_fallocate(sink->fd, start, MMAP_SINK_CHUNK) != 0)
+		return (mmap_sink_fail(sink));
+	if (sink->size < start + MMAP_SINK_CHUNK)
+		sink->size = start + MMAP_SINK_CHUNK;
+	map = mmap(NULL, MMAP_SINK_CHUNK, PROT_READ | PROT_WRITE, MAP_SHARED,
+			sink->fd, start);
+	if (map == MAP_FAILED)
+		return (mmap_sink_fail(sink));
+
+	sink->map = map;
+	sink->map_start = start;
+	sink->out.buf = sink->map + (sink->tail - start);
+	sink->out.cap = MMAP_SINK_CHUNK - (sink->tail - start);
+	sink->out.len = 0;
+
+	return (0);
+}
+
+/**
+ * mmap_sink_flush - Flush callback of mmap sinks.
+ *
+ * The pending bytes are already in the file's pages, so flushing only
+ * advances the tail past them. When the window is used up the next one is
+ * mapped.
+ *
+ * @out: The writer embedded in an mmap_sink_t.
+ *
+ * Return: 0 on success, -1 on failure.
+ */
+static int mmap_sink_flush(writer_t *out)
+{
+	mmap_sink_t *sink = out->ctx;
+
+	sink->tail += out->len;
+	out->buf += out->len;
+	out->cap -= out->len;
+	out->len = 0;
+
+	if (out->cap == 0)
+		return (mmap_sink_map(sink));
+
+	return (0);
+}
+
+/**
+ * mmap_sink_open - Open a log file for formatting through a mapping.
+ *
+ * The file is created if needed and new output is appended after its
+ * current contents. The file grows in MMAP_SINK_CHUNK steps while the sink
+ * is open and is cut back to the bytes actually written by mmap_sink_close.
+ * Format into it with _wprintf(&sink->out, ...). A sink must only be used
+ * by one thread at a time.
+ *
+ * @sink: The sink to initialize.
+ * @path: The path of the log file.
+ *
+ * Return: 0 on success, -1 on failure.
+ */
+int mmap_sink_open(mmap_sink_t *sink, const char *path)
+{
+	struct stat st;
+
+	sink->map = NULL;
+	sink->fd = open(path, O_RDWR | O_CREAT, 0644);
+	if (sink->fd == -1)
+		return (-1);
+	if (fstat(sink->fd, &st) == -1)
+	{
+		close(sink->fd);
+		return (-1);
+	}
+
+	writer_init(&sink->out, NULL, 0, sink->scratch, sink->fd);
+	sink->out.flush = mmap_sink_flush;
+	sink->out.ctx = sink;
+	sink->tail = st.st_size;
+	sink->size = st.st_size;
+
+	if (mmap_sink_map(sink) == -1)
+	{
+		close(sink->fd);
+		return (-1);
+	}
+
+	return (0);
+}
+
+/**
+ * mmap_sink_close - Commit the output of an mmap sink and close it.
+ *
+ * The mapping is released and the file is truncated to the length that
+ * was actually written, dropping the unused part of the last chunk.
+ *
+ * @sink: The sink to close.
+ *
+ * Return: 0 on success, -1 if any output was lost.
+ */
+int mmap_sink_close(mmap_sink_t *sink)
+{
+	int error = sink->out.error;
+
+	sink->tail += sink->out.len;
+	sink->out.len = 0;
+	if (sink->map != NULL)
+		munmap(sink->map, MMAP_SINK_CHUNK);
+	sink->map = NULL;
+
+	if (ftruncate(sink->fd, sink->tail) == -1)
+		error = 1;
+	if (close(sink->fd) == -1)
+		error = 1;
+
+	return (error ? -1 : 0);
+}
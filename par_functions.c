@@ -0,0 +1,233 @@
+#include "main.h"
+#include <limits.h>
+#include <stdlib.h>
+
+/**
+ * struct par_job - State shared by the workers of one par_format call.
+ * @records: The records.
+ * @size: The size of one record.
+ * @count: The number of records.
+ * @fn: Formats one record.
+ * @next: The next chunk of PAR_CHUNK records no worker has claimed.
+ * @emit: The chunk whose turn it is to be written.
+ * @error: Set once a record or a write has failed.
+ * @printed: Characters produced by the workers that have finished.
+ * @lock: Protects @emit.
+ * @cond: Signals a change of @emit.
+ */
+struct par_job
+{
+	const char *records;
+	size_t size;
+	long count;
+	par_fn fn;
+	long next;
+	long emit;
+	int error;
+	long printed;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+};
+
+/**
+ * struct par_worker - One formatting thread of par_format.
+ * @job: The shared state.
+ * @thread: The thread, unused for the caller's own worker.
+ * @out: The writer a whole chunk is formatted into.
+ * @scratch: Conversion scratch space for @out.
+ */
+struct par_worker
+{
+	struct par_job *job;
+	pthread_t thread;
+	writer_t out;
+	char scratch[BUFF_SIZE];
+};
+
+/**
+ * par_grow - Flush callback of the workers' writers.
+ *
+ * A chunk is kept whole until its turn to be written, so instead of
+ * writing anything the buffer is doubled.
+ *
+ * @out: The worker's writer.
+ *
+ * Return: 0 on success, -1 if the buffer cannot grow.
+ */
+static int par_grow(writer_t *out)
+{
+	char *buf = NULL;
+
+	if (out->cap <= INT_MAX / 2)
+		buf = realloc(out->buf, (size_t)out->cap * 2);
+	if (buf == NULL)
+	{
+		out->error = 1;
+		return (-1);
+	}
+	out->buf = buf;
+	out->cap *= 2;
+
+	return (0);
+}
+
+/**
+ * par_emit - Write a formatted chunk once every earlier chunk is out.
+ *
+ * The chunk is written in one go through the writer's usual sink (the
+ * shared stdout sink for fd 1, print_buffer otherwise) without holding
+ * the lock, since only the chunk whose turn it is writes at all.
+ *
+ * @w: The worker holding the chunk.
+ * @chunk: The chunk's index.
+ */
+static void par_emit(struct par_worker *w, long chunk)
+{
+	struct par_job *job = w->job;
+
+	pthread_mutex_lock(&job->lock);
+	while (job->emit != chunk)
+		pthread_cond_wait(&job->cond, &job->lock);
+	pthread_mutex_unlock(&job->lock);
+
+	if (__atomic_load_n(&job->error, __ATOMIC_RELAXED))
+		w->out.len = 0;
+	w->out.flush = w->out.fd == 1 ? fd_sink_flush : print_buffer;
+	if (writer_flush(&w->out) == -1)
+		__atomic_store_n(&job->error, 1, __ATOMIC_RELAXED);
+	w->out.flush = par_grow;
+
+	pthread_mutex_lock(&job->lock);
+	job->emit++;
+	pthread_cond_broadcast(&job->cond);
+	pthread_mutex_unlock(&job->lock);
+}
+
+/**
+ * par_worker - Claim chunks of records, format them and write them.
+ *
+ * Workers take the next unclaimed chunk from a shared atomic cursor, so
+ * a fast worker simply takes more chunks and no thread sits idle while
+ * records remain. After a failure the remaining chunks are still claimed
+ * and passed on in order, but not formatted.
+ *
+ * @arg: The worker's struct par_worker.
+ *
+ * Return: NULL.
+ */
+static void *par_worker(void *arg)
+{
+	struct par_worker *w = arg;
+	struct par_job *job = w->job;
+	long chunk, i, end, printed = 0;
+	long chunks = (job->count + PAR_CHUNK - 1) / PAR_CHUNK;
+	int len;
+
+	while ((chunk = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED))
+			< chunks)
+	{
+		end = chunk * PAR_CHUNK + PAR_CHUNK;
+		if (end > job->count)
+			end = job->count;
+		for (i = chunk * PAR_CHUNK; i < end; i++)
+		{
+			if (__atomic_load_n(&job->error, __ATOMIC_RELAXED))
+				break;
+			len = job->fn(&w->out, job->records + i * job->size);
+			if (len == -1 || w->out.error)
+				break;
+			printed += len;
+		}
+		if (i < end)
+			__atomic_store_n(&job->error, 1, __ATOMIC_RELAXED);
+		par_emit(w, chunk);
+	}
+	__atomic_fetch_add(&job->printed, printed, __ATOMIC_RELAXED);
+
+	return (NULL);
+}
+
+/**
+ * par_threads - Decide how many workers a job gets.
+ *
+ * @threads: The number asked for, or 0 for one per online CPU.
+ * @chunks: The number of chunks in the job; more workers would idle.
+ *
+ * Return: The number of workers, from 1 to PAR_THREADS.
+ */
+static int par_threads(int threads, long chunks)
+{
+	if (threads <= 0)
+		threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	if (threads > chunks)
+		threads = chunks;
+	if (threads > PAR_THREADS)
+		threads = PAR_THREADS;
+
+	return (threads < 1 ? 1 : threads);
+}
+
+/**
+ * par_format - Format an array of records on several threads, in order.
+ *
+ * The records are cut into chunks of PAR_CHUNK. Each worker formats the
+ * chunks it claims into its own growing buffer and writes each one, in
+ * a single write, as soon as all earlier chunks are out, so the output
+ * is exactly what formatting the records one by one would give. The
+ * calling thread is one of the workers; if some threads cannot be
+ * started the others do their share.
+ *
+ * @fd: The destination file descriptor; 1 goes through the stdout sink.
+ * @records: The records.
+ * @size: The size of one record.
+ * @count: The number of records.
+ * @fn: Formats one record; called from several threads at once.
+ * @threads: The number of workers, or 0 for one per online CPU.
+ *
+ * Return: The number of characters produced, or -1 on error.
+ */
+long par_format(int fd, const void *records, size_t size, long count,
+		par_fn fn, int threads)
+{
+	struct par_job job = {NULL, 0, 0, NULL, 0, 0, 0, 0,
+		PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER};
+	struct par_worker *w;
+	int i, n;
+
+	if (fn == NULL || count < 0 || (records == NULL && count > 0))
+		return (-1);
+	threads = par_threads(threads, (count + PAR_CHUNK - 1) / PAR_CHUNK);
+	w = malloc(threads * sizeof(*w));
+	if (w == NULL)
+		return (-1);
+	job.records = records, job.size = size, job.count = count, job.fn = fn;
+
+	for (n = 0; n < threads; n++)
+	{
+		w[n].job = &job;
+		writer_init(&w[n].out, malloc(PAR_BUF_SIZE), PAR_BUF_SIZE,
+				w[n].scratch, fd);
+		w[n].out.flush = par_grow;
+		w[n].out.ctx = fd == 1 ? fd_sink_stdout() : NULL;
+		if (w[n].out.buf == NULL || (n > 0 &&
+				pthread_create(&w[n].thread, NULL,
+					par_worker, &w[n]) != 0))
+		{
+			free(w[n].out.buf);
+			break;
+		}
+	}
+	if (n > 0)
+		par_worker(&w[0]);
+	for (i = 0; i < n; i++)
+	{
+		if (i > 0)
+			pthread_join(w[i].thread, NULL);
+		free(w[i].out.buf);
+	}
+	free(w);
+	if (n == 0)
+		return (-1);
+
+	return (job.error ? -1 : job.printed);
+}
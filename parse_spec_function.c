@@ -0,0 +1,117 @@
+#include "main.h"
+
+/*
+ * Parser states, in the order the parts of a directive appear:
+ * %[flags][width][.precision][size]conversion
+ */
+#define P_FLAGS 0
+#define P_WIDTH 1
+#define P_PRECISION 2
+#define P_SIZE 3
+
+/**
+ * flag_bit - Map a flag character to its F_* bit.
+ *
+ * @c: The character.
+ *
+ * Return: The flag bit, or 0 if @c is not a flag.
+ */
+static int flag_bit(char c)
+{
+	switch (c)
+	{
+	case '-':
+		return (F_MINUS);
+	case '+':
+		return (F_PLUS);
+	case '0':
+		return (F_ZERO);
+	case '#':
+		return (F_HASH);
+	case ' ':
+		return (F_SPACE);
+	}
+
+	return (0);
+}
+
+/**
+ * parse_number - Read a field made of digits, or a '*'.
+ *
+ * Digits accumulate into the value; a '*' replaces it with the next int
+ * argument and ends the field.
+ *
+ * @format: The format string.
+ * @j: Index of the first character of the field; left past it.
+ * @list: The arguments, for '*'.
+ *
+ * Return: The value of the field, 0 if it is empty.
+ */
+static int parse_number(const char *format, int *j, va_list list)
+{
+	int value = 0;
+
+	for (; is_digit(format[*j]); (*j)++)
+		value = value * 10 + (format[*j] - '0');
+	if (format[*j] == '*')
+	{
+		(*j)++;
+		value = va_arg(list, int);
+	}
+
+	return (value);
+}
+
+/**
+ * parse_spec - Parse a conversion directive in one pass.
+ *
+ * The directive is walked once, left to right, by a small state machine
+ * that moves from flags to width to precision to size and stops at the
+ * conversion character, filling @spec as it goes. Width and precision
+ * given as '*' are taken from the arguments in the order they appear.
+ *
+ * @format: The format string.
+ * @i: Index of the '%'; on return, index of the conversion character.
+ * @list: The arguments, for '*' width and precision.
+ * @spec: Receives the parsed directive.
+ */
+void parse_spec(const char *format, int *i, va_list list, spec_t *spec)
+{
+	int j = *i + 1, state = P_FLAGS, bit;
+
+	spec->flags = 0, spec->width = 0, spec->precision = -1, spec->size = 0;
+	while (state <= P_SIZE)
+	{
+		if (state == P_FLAGS)
+		{
+			bit = flag_bit(format[j]);
+			spec->flags |= bit;
+			j += bit != 0;
+			state = bit ? P_FLAGS : P_WIDTH;
+		}
+		else if (state == P_WIDTH)
+		{
+			spec->width = parse_number(format, &j, list);
+			state = P_PRECISION;
+		}
+		else if (state == P_PRECISION)
+		{
+			if (format[j] == '.')
+			{
+				j++;
+				spec->precision = parse_number(format, &j, list);
+			}
+			state = P_SIZE;
+		}
+		else
+		{
+			spec->size = format[j] == 'l' ? S_LONG :
+				format[j] == 'h' ? S_SHORT : 0;
+			j += spec->size != 0;
+			state++;
+		}
+	}
+
+	spec->conv = format[j];
+	*i = j;
+}
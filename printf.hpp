@@ -0,0 +1,349 @@
+#ifndef PRINTF_HPP
+#define PRINTF_HPP
+
+/*
+ * printf.hpp - compile-time checked C++ front end for _printf (C++20).
+ *
+ * The format string is a template argument, so the compiler parses it once
+ * into a table of literal runs and conversions using the same rules as
+ * parse_spec, and each conversion becomes a constant spec_t. Every
+ * argument is then checked against its conversion with static_assert, and
+ * the call expands to a fixed sequence of calls into the value converters
+ * (print_int_value, print_unsigned_value, print_string_value,
+ * print_wide_value, print_wide_char, print_pointer_value and
+ * handle_write_char). Nothing is parsed and no va_list is built at run
+ * time. _printf_ct writes through the same stdout sink as _printf, so the
+ * two never reorder, and rate limiting, repeat suppression and capture
+ * apply; the arguments are handed to the capture trace only while
+ * _printf_capture is recording.
+ *
+ *	_printf_ct<"%s: %5ld\n">(name, total);
+ *	_wprintf_ct<"%d\n">(&writer, value);
+ *
+ * Supported conversions: c s % d i u o x X p, with the usual flags, width,
+ * precision ('*' included) and the h / l size modifiers; %lc and %ls take
+ * a wide character and a wide string and write UTF-8 as _printf does. The
+ * string-only extensions (b S r R) have no value converter and are
+ * rejected at compile time; keep using _printf for those.
+ */
+
+extern "C" {
+#include "main.h"
+}
+
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace printf_ct
+{
+
+/**
+ * struct fixed_string - A string literal usable as a template argument.
+ * @str: The characters, including the terminating NUL.
+ */
+template <std::size_t N>
+struct fixed_string
+{
+	char str[N]{};
+
+	constexpr fixed_string(const char (&s)[N])
+	{
+		for (std::size_t i = 0; i < N; i++)
+			str[i] = s[i];
+	}
+
+	constexpr std::size_t size() const { return (N - 1); }
+};
+
+/**
+ * struct directive - One compiled element of a format string.
+ * @literal: True for a run of plain text.
+ * @begin: Offset of the literal run in the format string.
+ * @length: Length of the literal run.
+ * @conv: Conversion character.
+ * @flags: F_* flags.
+ * @width: Width, or the '*' placeholder value 0.
+ * @precision: Precision, -1 when absent.
+ * @size: S_LONG, S_SHORT or 0.
+ * @width_arg: True when the width comes from an argument.
+ * @precision_arg: True when the precision comes from an argument.
+ * @width_index: Argument index of the '*' width.
+ * @precision_index: Argument index of the '*' precision.
+ * @arg: Argument index of the converted value.
+ */
+struct directive
+{
+	bool literal = true;
+	std::size_t begin = 0, length = 0;
+	char conv = 0;
+	int flags = 0, width = 0, precision = -1, size = 0;
+	bool width_arg = false, precision_arg = false;
+	std::size_t width_index = 0, precision_index = 0, arg = 0;
+};
+
+/**
+ * struct summary - Totals produced by scan().
+ * @count: Number of directives.
+ * @nargs: Number of arguments consumed.
+ */
+struct summary
+{
+	std::size_t count = 0, nargs = 0;
+};
+
+constexpr int flag_bit(char c)
+{
+	return (c == '-' ? F_MINUS : c == '+' ? F_PLUS : c == '0' ? F_ZERO :
+		c == '#' ? F_HASH : c == ' ' ? F_SPACE : 0);
+}
+
+constexpr bool is_value_conv(char c)
+{
+	return (c == 'c' || c == 's' || c == 'd' || c == 'i' || c == 'u' ||
+		c == 'o' || c == 'x' || c == 'X' || c == 'p');
+}
+
+/*
+ * scan - Parse @s into directives, storing them in @out when non-null.
+ * Reaching a throw during constant evaluation is a compile error, which is
+ * how malformed formats are reported.
+ */
+constexpr summary scan(const char *s, std::size_t n, directive *out)
+{
+	summary sum;
+	std::size_t i = 0;
+
+	while (i < n)
+	{
+		directive d;
+
+		if (s[i] != '%')
+		{
+			d.begin = i;
+			while (i < n && s[i] != '%')
+				i++;
+			d.length = i - d.begin;
+		}
+		else
+		{
+			for (i++; i < n && flag_bit(s[i]); i++)
+				d.flags |= flag_bit(s[i]);
+			if (i < n && s[i] == '*')
+				d.width_arg = true, d.width_index = sum.nargs++, i++;
+			else
+				for (; i < n && s[i] >= '0' && s[i] <= '9'; i++)
+					d.width = d.width * 10 + (s[i] - '0');
+			if (i < n && s[i] == '.')
+			{
+				d.precision = 0;
+				if (++i < n && s[i] == '*')
+					d.precision_arg = true,
+					d.precision_index = sum.nargs++, i++;
+				else
+					for (; i < n && s[i] >= '0' && s[i] <= '9'; i++)
+						d.precision = d.precision * 10 + (s[i] - '0');
+			}
+			if (i < n && (s[i] == 'l' || s[i] == 'h'))
+				d.size = s[i++] == 'l' ? S_LONG : S_SHORT;
+			if (i >= n)
+				throw "_printf_ct: format ends inside a conversion";
+			d.conv = s[i];
+			if (d.conv == '%')
+				d.begin = i, d.length = 1;
+			else if (is_value_conv(d.conv))
+				d.literal = false, d.arg = sum.nargs++;
+			else
+				throw "_printf_ct: conversion not supported at compile time";
+			i++;
+		}
+		if (out)
+			out[sum.count] = d;
+		sum.count++;
+	}
+	return (sum);
+}
+
+/**
+ * struct compiled - The directive table for format @F.
+ */
+template <fixed_string F>
+struct compiled
+{
+	static constexpr summary info = scan(F.str, F.size(), nullptr);
+	static constexpr std::array<directive, info.count> table = [] {
+		std::array<directive, info.count> t{};
+
+		scan(F.str, F.size(), t.data());
+		return (t);
+	}();
+};
+
+template <class T>
+using bare = std::remove_cvref_t<std::decay_t<T>>;
+
+template <class T>
+constexpr bool is_small_int = std::is_integral_v<T> &&
+	sizeof(T) <= sizeof(int);
+
+/*
+ * check - static_assert that an argument of type T fits directive @d.
+ */
+template <directive d, class T>
+constexpr void check()
+{
+	if constexpr (d.conv == 'c')
+		static_assert(is_small_int<T>, "_printf_ct: %c needs a char or int");
+	else if constexpr (d.conv == 's' && d.size == S_LONG)
+		static_assert(std::is_convertible_v<T, const wchar_t *>,
+			"_printf_ct: %ls needs a wide C string");
+	else if constexpr (d.conv == 's')
+		static_assert(std::is_convertible_v<T, const char *>,
+			"_printf_ct: %s needs a C string");
+	else if constexpr (d.conv == 'p')
+		static_assert(std::is_pointer_v<T> || std::is_null_pointer_v<T>,
+			"_printf_ct: %p needs a pointer");
+	else if constexpr (d.size == S_LONG)
+		static_assert(std::is_integral_v<T> && sizeof(T) == sizeof(long),
+			"_printf_ct: %l conversions need a long argument");
+	else
+		static_assert(is_small_int<T>,
+			"_printf_ct: integer conversion needs an int-sized argument");
+}
+
+/*
+ * emit - Output directive @I of format @F.
+ */
+template <fixed_string F, std::size_t I, class Tuple>
+inline int emit(writer_t *out, const Tuple &args)
+{
+	constexpr directive d = compiled<F>::table[I];
+
+	if constexpr (d.literal)
+	{
+		return (writer_write(out, F.str + d.begin, static_cast<int>(d.length)));
+	}
+	else
+	{
+		using T = bare<std::tuple_element_t<d.arg, Tuple>>;
+		const auto &v = std::get<d.arg>(args);
+		int width = d.width, precision = d.precision;
+
+		check<d, T>();
+		if constexpr (d.width_arg)
+		{
+			static_assert(is_small_int<bare<std::tuple_element_t<
+				d.width_index, Tuple>>>, "_printf_ct: '*' needs an int");
+			width = static_cast<int>(std::get<d.width_index>(args));
+		}
+		if constexpr (d.precision_arg)
+		{
+			static_assert(is_small_int<bare<std::tuple_element_t<
+				d.precision_index, Tuple>>>, "_printf_ct: '*' needs an int");
+			precision = static_cast<int>(std::get<d.precision_index>(args));
+		}
+		const spec_t spec = {width, precision,
+			static_cast<unsigned char>(d.flags),
+			static_cast<unsigned char>(d.size), d.conv};
+
+		if constexpr (d.conv == 'c' && d.size == S_LONG)
+			return (print_wide_char(static_cast<wint_t>(v), out, &spec));
+		else if constexpr (d.conv == 'c')
+			return (handle_write_char(static_cast<char>(v), out, &spec));
+		else if constexpr (d.conv == 's' && d.size == S_LONG)
+			return (print_wide_value(v, out, &spec));
+		else if constexpr (d.conv == 's')
+			return (print_string_value(v, out, &spec));
+		else if constexpr (d.conv == 'p')
+			return (print_pointer_value(v, out, &spec));
+		else if constexpr (d.conv == 'd' || d.conv == 'i')
+			return (print_int_value(static_cast<long>(v), out, &spec));
+		else if constexpr (d.conv == 'u')
+			return (print_unsigned_value(static_cast<unsigned long>(v), 10,
+				"0123456789", 0, out, &spec));
+		else if constexpr (d.conv == 'o')
+			return (print_unsigned_value(static_cast<unsigned long>(v), 8,
+				"01234567", 0, out, &spec));
+		else if constexpr (d.conv == 'x')
+			return (print_unsigned_value(static_cast<unsigned long>(v), 16,
+				"0123456789abcdef", 'x', out, &spec));
+		else
+			return (print_unsigned_value(static_cast<unsigned long>(v), 16,
+				"0123456789ABCDEF", 'X', out, &spec));
+	}
+}
+
+/*
+ * c_arg - Pass an argument to a C variadic function as _printf gets it.
+ * Small integers are promoted by the call itself; a class convertible to
+ * a C string is converted first.
+ */
+template <class T>
+inline auto c_arg(const T &v)
+{
+	if constexpr (std::is_class_v<T>)
+		return (static_cast<const char *>(v));
+	else if constexpr (std::is_array_v<T>)
+		return (static_cast<const std::remove_extent_t<T> *>(v));
+	else
+		return (v);
+}
+
+template <fixed_string F, class Tuple, std::size_t... I>
+inline int run(writer_t *out, const Tuple &args, std::index_sequence<I...>)
+{
+	int total = 0, n = 0;
+	bool ok;
+
+	ok = (((n = emit<F, I>(out, args)) >= 0 && (total += n, true)) && ...);
+	return (ok ? total : -1);
+}
+
+} /* namespace printf_ct */
+
+/**
+ * _wprintf_ct - Format into a writer with a format compiled at build time.
+ * @out: The writer receiving the output; it is not flushed.
+ * @args: The values for the conversions in the format.
+ *
+ * Return: The number of characters produced, or -1 on error.
+ */
+template <printf_ct::fixed_string F, class... Args>
+inline int _wprintf_ct(writer_t *out, const Args &... args)
+{
+	using info = printf_ct::compiled<F>;
+
+	static_assert(sizeof...(Args) == info::info.nargs,
+		"_printf_ct: argument count does not match the format");
+	return (printf_ct::run<F>(out, std::forward_as_tuple(args...),
+		std::make_index_sequence<info::info.count>{}));
+}
+
+/**
+ * _printf_ct - Print to standard output with a format compiled at build
+ * time, through the stdout sink exactly like _printf.
+ * @args: The values for the conversions in the format.
+ *
+ * Return: The number of characters printed, 0 if rate limiting suppressed
+ * the call, or -1 on error.
+ */
+template <printf_ct::fixed_string F, class... Args>
+inline int _printf_ct(const Args &... args)
+{
+	char buffer[BUFF_SIZE], scratch[BUFF_SIZE];
+	writer_t out;
+	int printed;
+
+	if (!stdout_begin(&out, buffer, scratch, F.str))
+		return (0);
+	if (__atomic_load_n(&_printf_capture_on, __ATOMIC_RELAXED))
+		capture_callf(F.str, printf_ct::c_arg(args)...);
+	printed = _wprintf_ct<F>(&out, args...);
+	if (fd_sink_commit(&out) == -1)
+		return (-1);
+	return (printed);
+}
+
+#endif
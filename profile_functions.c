@@ -0,0 +1,106 @@
+#include "main.h"
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * Counters per phase and conversion character, updated with relaxed
+ * atomics so profiled programs may print from several threads.
+ */
+static prof_stat_t prof_stats[PROF_PHASES][256];
+static pthread_once_t prof_once = PTHREAD_ONCE_INIT;
+static int prof_muted;
+
+/**
+ * prof_now - Read the profiling clock.
+ *
+ * Return: The time stamp counter on x86, otherwise monotonic nanoseconds.
+ */
+unsigned long prof_now(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return ((unsigned long)__builtin_ia32_rdtsc());
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((unsigned long)ts.tv_sec * 1000000000UL + ts.tv_nsec);
+#endif
+}
+
+/**
+ * prof_atexit - Register prof_dump to run at exit.
+ */
+static void prof_atexit(void)
+{
+	atexit(prof_dump);
+}
+
+/**
+ * prof_record - Account one timed phase of a conversion.
+ *
+ * Called through PROF_END, which only exists in PRINTF_PROFILE builds.
+ * Cycles go into a log2 histogram so outliers stay visible.
+ *
+ * @phase: PROF_PARSE, PROF_CONVERT or PROF_FLUSH.
+ * @spec: The conversion character, 0 for flushes.
+ * @cycles: The time spent, in prof_now units.
+ * @bytes: The bytes produced.
+ */
+void prof_record(int phase, char spec, unsigned long cycles, int bytes)
+{
+	prof_stat_t *st = &prof_stats[phase][(unsigned char)spec];
+	int bucket = cycles ? 63 - __builtin_clzl(cycles) : 0;
+
+	if (__atomic_load_n(&prof_muted, __ATOMIC_RELAXED))
+		return;
+	pthread_once(&prof_once, prof_atexit);
+	if (bucket >= PROF_BUCKETS)
+		bucket = PROF_BUCKETS - 1;
+	__atomic_fetch_add(&st->count, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&st->cycles, cycles, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&st->bytes, bytes > 0 ? bytes : 0, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&st->hist[bucket], 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * prof_dump_stat - Print the counters of one phase and character.
+ *
+ * @buf: Staging buffer for the output.
+ * @phase: The phase.
+ * @spec: The conversion character.
+ */
+static void prof_dump_stat(char *buf, int phase, int spec)
+{
+	prof_stat_t *st = &prof_stats[phase][spec];
+	const char *names[PROF_PHASES] = {"parse", "convert", "flush"};
+	int b;
+
+	_dprintf_sigsafe(2, buf, BUFF_SIZE, "%s %c: %lu calls, %lu bytes, %lu avg,",
+			names[phase], spec ? spec : '-', st->count, st->bytes,
+			st->cycles / st->count);
+	for (b = 0; b < PROF_BUCKETS; b++)
+		if (st->hist[b])
+			_dprintf_sigsafe(2, buf, BUFF_SIZE, " <%lu:%lu",
+					2UL << b, st->hist[b]);
+	_dprintf_sigsafe(2, buf, BUFF_SIZE, "\n");
+}
+
+/**
+ * prof_dump - Print the profile to standard error.
+ *
+ * For each phase and conversion character: calls, bytes produced, average
+ * cycles and the cycle histogram as "<limit:calls" buckets. Registered to
+ * run at exit on first use; it may also be called directly.
+ */
+void prof_dump(void)
+{
+	char buf[BUFF_SIZE];
+	int phase, spec;
+
+	__atomic_store_n(&prof_muted, 1, __ATOMIC_RELAXED);
+	for (phase = 0; phase < PROF_PHASES; phase++)
+		for (spec = 0; spec < 256; spec++)
+			if (prof_stats[phase][spec].count)
+				prof_dump_stat(buf, phase, spec);
+	__atomic_store_n(&prof_muted, 0, __ATOMIC_RELAXED);
+}
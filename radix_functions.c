@@ -0,0 +1,117 @@
+#include "main.h"
+
+/**
+ * radix_digits - Write a value in base 2, 8 or 16, most significant first.
+ *
+ * Digits are produced forward with shifts and masks. Hexadecimal uses the
+ * SSE2 kernel, which converts all sixteen nibbles of a 64-bit value at
+ * once, and keeps the last @n of them.
+ *
+ * @num: The value.
+ * @shift: Bits per digit: 1, 3 or 4.
+ * @n: The number of digits to write.
+ * @map_to: The digit characters.
+ * @dst: Where the digits are stored.
+ */
+static void radix_digits(unsigned long num, int shift, int n,
+		const char *map_to, char *dst)
+{
+	int i;
+	unsigned long mask = (1UL << shift) - 1;
+#ifdef __SSE2__
+	char hex[16];
+
+	if (shift == 4)
+	{
+		hex16_sse2(num, hex, map_to[10] == 'A');
+		memcpy(dst, hex + 16 - n, n);
+		return;
+	}
+#endif
+	for (i = 0; i < n; i++)
+		dst[i] = map_to[(num >> (n - 1 - i) * shift) & mask];
+}
+
+/**
+ * print_radix_value - Print an unsigned value in base 2, 8 or 16.
+ *
+ * This is the kernel behind %b, %o, %x, %X and %p. The digit count comes
+ * straight from the highest set bit (clz), so digits are written forward
+ * into the scratch space with no divisions and no reversal. Prefix, sign,
+ * precision and padding are left to write_digits. The '#' flag makes
+ * octal output start with a 0 (as a "0" prefix unless precision already
+ * adds one); other prefixes are chosen by the caller.
+ *
+ * @num: The value, already narrowed to its size.
+ * @shift: Bits per digit: 1 (binary), 3 (octal) or 4 (hexadecimal).
+ * @map_to: The digit characters.
+ * @prefix: Text before the digits ("0x", "0X", "0b"), or NULL.
+ * @sign: A '+' or ' ' to print first, or 0.
+ * @out: The writer receiving the output.
+ * @spec: The parsed directive; precision is the minimum number of digits.
+ *
+ * Return: The number of characters printed.
+ */
+int print_radix_value(unsigned long num, int shift, const char *map_to,
+		const char *prefix, char sign, writer_t *out, const spec_t *spec)
+{
+	int bits = num ? 64 - __builtin_clzl(num) : 1;
+	int n = (bits + shift - 1) / shift, precision = spec->precision;
+
+	if (num == 0 && precision == 0)
+		n = 0;
+	radix_digits(num, shift, n, map_to, out->scratch);
+
+	if (shift == 3 && (spec->flags & F_HASH) && precision <= n &&
+			(num != 0 || n == 0))
+		prefix = "0";
+
+	return (write_digits(out, out->scratch, n, prefix, sign, spec));
+}
+
+/**
+ * write_digits - Write converted digits with sign, prefix, precision and
+ * padding.
+ *
+ * Every integer conversion ends here. Precision adds leading zeros after
+ * the sign and prefix; without a precision the '0' flag pads to the width
+ * with zeros in the same place; otherwise the width is padded with spaces
+ * on the left, or on the right with '-'.
+ *
+ * @out: The writer receiving the output.
+ * @digits: The digits, most significant first.
+ * @n: The number of digits (0 for a zero printed with precision 0).
+ * @prefix: Text between the sign and the digits, or NULL.
+ * @sign: A '-', '+' or ' ' to print first, or 0.
+ * @spec: The parsed directive; precision is the minimum number of digits.
+ *
+ * Return: The number of characters printed.
+ */
+int write_digits(writer_t *out, const char *digits, int n,
+		const char *prefix, char sign, const spec_t *spec)
+{
+	int plen = prefix ? (int)strlen(prefix) : 0, flags = spec->flags;
+	int zeros = spec->precision > n ? spec->precision - n : 0;
+	int len = (sign != 0) + plen + zeros + n, pad = 0, width = spec->width;
+
+	if (width > len)
+	{
+		if ((flags & F_ZERO) && !(flags & F_MINUS) && spec->precision < 0)
+			zeros += width - len;
+		else
+			pad = width - len;
+		len = width;
+	}
+
+	if (!(flags & F_MINUS))
+		writer_pad(out, ' ', pad);
+	if (sign)
+		writer_write(out, &sign, 1);
+	writer_write(out, prefix, plen);
+	writer_pad(out, '0', zeros);
+	writer_write(out, digits, n);
+	if (flags & F_MINUS)
+		writer_pad(out, ' ', pad);
+
+	return (len);
+}
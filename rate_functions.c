@@ -0,0 +1,203 @@
+#include "main.h"
+#include <time.h>
+
+/**
+ * struct rate_site - Rate-limiting state of one call site.
+ * @format: The format string pointer identifying the site, NULL if free.
+ * @tat: Token bucket state: the time, in ns, at which the bucket is full.
+ * @count: Calls seen, for 1-in-N sampling.
+ * @dropped: Calls suppressed since the last summary.
+ */
+struct rate_site
+{
+	const char *format;
+	unsigned long tat;
+	unsigned long count;
+	unsigned long dropped;
+};
+
+static struct rate_site rate_sites[RATE_SITES];
+static int rate_mode = RATE_OFF;
+static unsigned long rate_n = 1, rate_interval, rate_tau, rate_next_report;
+
+/**
+ * rate_now - Read the monotonic clock.
+ *
+ * Return: The time in nanoseconds.
+ */
+static unsigned long rate_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ((unsigned long)ts.tv_sec * 1000000000UL + ts.tv_nsec);
+}
+
+/**
+ * rate_site - Find or claim the table entry of a call site.
+ *
+ * The table is open-addressed on the format pointer and entries are
+ * claimed with a compare-and-swap, so lookups take no lock.
+ *
+ * @format: The format string pointer.
+ *
+ * Return: The entry, or NULL if the table is full.
+ */
+static struct rate_site *rate_site(const char *format)
+{
+	unsigned long h = (unsigned long)format * 0x9E3779B97F4A7C15UL >> 32;
+	const char *key;
+	int i;
+
+	for (i = 0; i < RATE_SITES; i++, h++)
+	{
+		struct rate_site *site = &rate_sites[h & (RATE_SITES - 1)];
+
+		key = __atomic_load_n(&site->format, __ATOMIC_ACQUIRE);
+		if (key == NULL && __atomic_compare_exchange_n(&site->format,
+					&key, format, 0, __ATOMIC_ACQ_REL,
+					__ATOMIC_ACQUIRE))
+			return (site);
+		if (key == format)
+			return (site);
+	}
+
+	return (NULL);
+}
+
+/**
+ * rate_admit - Decide whether a call site may print now.
+ *
+ * This runs before any directive is parsed or argument fetched. With
+ * RATE_SAMPLE one call in N per site is let through. With RATE_LIMIT each
+ * site has a token bucket, kept as a single timestamp (the time the bucket
+ * would be full) and updated with a compare-and-swap. A suppressed call
+ * is counted for the next summary. Sites that do not fit in the table
+ * are never suppressed.
+ *
+ * @format: The format string pointer, which identifies the call site.
+ *
+ * Return: 1 if the call may print, 0 if it is suppressed.
+ */
+int rate_admit(const char *format)
+{
+	int mode = __atomic_load_n(&rate_mode, __ATOMIC_ACQUIRE);
+	struct rate_site *site;
+	unsigned long now, tat, next, tau, interval;
+
+	if (mode == RATE_OFF)
+		return (1);
+	site = rate_site(format);
+	if (site == NULL)
+		return (1);
+
+	if (mode == RATE_SAMPLE)
+	{
+		next = __atomic_fetch_add(&site->count, 1, __ATOMIC_RELAXED);
+		if (next % __atomic_load_n(&rate_n, __ATOMIC_RELAXED) == 0)
+			return (1);
+	}
+	else
+	{
+		tau = __atomic_load_n(&rate_tau, __ATOMIC_RELAXED);
+		interval = __atomic_load_n(&rate_interval, __ATOMIC_RELAXED);
+		now = rate_now();
+		tat = __atomic_load_n(&site->tat, __ATOMIC_RELAXED);
+		do {
+			next = tat > now ? tat : now;
+			if (next - now > tau)
+				break;
+		} while (!__atomic_compare_exchange_n(&site->tat, &tat,
+					next + interval, 1, __ATOMIC_RELAXED,
+					__ATOMIC_RELAXED));
+		if (next - now <= tau)
+			return (1);
+	}
+	__atomic_fetch_add(&site->dropped, 1, __ATOMIC_RELAXED);
+
+	return (0);
+}
+
+/**
+ * rate_report - Write the periodic summary of suppressed calls.
+ *
+ * At most once every RATE_REPORT_SEC seconds, the first caller to get here
+ * writes one line per site that dropped calls since the last summary,
+ * naming the site by its format string.
+ *
+ * @out: The writer receiving the summary lines.
+ *
+ * Return: The number of characters written.
+ */
+int rate_report(writer_t *out)
+{
+	unsigned long now, next, dropped;
+	struct rate_site *site;
+	const char *format;
+	int i, printed = 0;
+
+	if (__atomic_load_n(&rate_mode, __ATOMIC_RELAXED) == RATE_OFF)
+		return (0);
+	now = rate_now();
+	next = __atomic_load_n(&rate_next_report, __ATOMIC_RELAXED);
+	if (now < next)
+		return (0);
+	if (!__atomic_compare_exchange_n(&rate_next_report, &next,
+				now + RATE_REPORT_SEC * 1000000000UL, 0,
+				__ATOMIC_RELAXED, __ATOMIC_RELAXED))
+		return (0);
+
+	for (i = 0; i < RATE_SITES; i++)
+	{
+		site = &rate_sites[i];
+		format = __atomic_load_n(&site->format, __ATOMIC_ACQUIRE);
+		if (format == NULL)
+			continue;
+		dropped = __atomic_exchange_n(&site->dropped, 0,
+				__ATOMIC_RELAXED);
+		if (dropped > 0)
+			printed += _wprintf(out,
+					"_printf: suppressed %lu calls of %J\n",
+					dropped, format);
+	}
+
+	return (printed);
+}
+
+/**
+ * _printf_set_rate - Choose how _printf limits call sites.
+ *
+ * RATE_OFF (the default) prints everything. RATE_LIMIT lets each call
+ * site, identified by its format string pointer, print @n lines per
+ * second with bursts of up to @burst lines. RATE_SAMPLE prints one call
+ * in @n per site. Suppressed calls return 0 without touching their
+ * arguments and are reported by a summary line every RATE_REPORT_SEC
+ * seconds.
+ *
+ * @mode: RATE_OFF, RATE_LIMIT or RATE_SAMPLE.
+ * @n: Lines per second (RATE_LIMIT) or the sampling period (RATE_SAMPLE).
+ * Rates above one line per nanosecond are treated as one per nanosecond.
+ * @burst: The bucket size for RATE_LIMIT, at least 1; unused otherwise.
+ *
+ * Return: 0 on success, -1 if the arguments are invalid.
+ */
+int _printf_set_rate(int mode, unsigned long n, unsigned long burst)
+{
+	if (mode != RATE_OFF && mode != RATE_LIMIT && mode != RATE_SAMPLE)
+		return (-1);
+	if (mode != RATE_OFF && (n == 0 || (mode == RATE_LIMIT && burst == 0)))
+		return (-1);
+
+	if (mode == RATE_LIMIT)
+	{
+		n = n < 1000000000UL ? 1000000000UL / n : 1;
+		__atomic_store_n(&rate_interval, n, __ATOMIC_RELAXED);
+		__atomic_store_n(&rate_tau, (burst - 1) * n, __ATOMIC_RELAXED);
+	}
+	else if (mode == RATE_SAMPLE)
+		__atomic_store_n(&rate_n, n, __ATOMIC_RELAXED);
+	__atomic_store_n(&rate_mode, mode, __ATOMIC_RELEASE);
+
+	return (0);
+}
@@ -0,0 +1,107 @@
+#include "main.h"
+#include <stdlib.h>
+
+static fd_sink_t stdout_sink;
+static pthread_once_t stdout_once = PTHREAD_ONCE_INIT;
+
+/**
+ * stdout_sink_exit - Drain the stdout sink when the program exits.
+ *
+ * Queued output gets FD_SINK_EXIT_WAIT ms at a time to go out. If any
+ * output to standard output was dropped during the run, the total is
+ * reported on standard error.
+ */
+static void stdout_sink_exit(void)
+{
+	char buffer[BUFF_SIZE];
+	unsigned long dropped;
+
+	fd_sink_finish(&stdout_sink, FD_SINK_EXIT_WAIT);
+	dropped = fd_sink_dropped(&stdout_sink);
+	if (dropped > 0)
+		_dprintf_sigsafe(2, buffer, BUFF_SIZE,
+				"_printf: %lu bytes of stdout dropped\n",
+				dropped);
+}
+
+/**
+ * stdout_sink_init - Open the shared stdout sink.
+ */
+static void stdout_sink_init(void)
+{
+	fd_sink_open(&stdout_sink, 1, FD_SINK_DROP_NEW, 0);
+	atexit(stdout_sink_exit);
+}
+
+/**
+ * fd_sink_stdout - Get the sink _printf writes standard output through.
+ *
+ * The sink is created on first use with FD_SINK_DROP_NEW, so a
+ * non-blocking stdout queues what it cannot take and never makes _printf
+ * wait; use fd_sink_set_policy to change that, and fd_sink_drain to retry
+ * queued output from outside _printf. What is still queued when the
+ * program exits is drained then, and fd_sink_dropped tells how much
+ * output was lost.
+ *
+ * Return: The stdout sink.
+ */
+fd_sink_t *fd_sink_stdout(void)
+{
+	pthread_once(&stdout_once, stdout_sink_init);
+
+	return (&stdout_sink);
+}
+
+/**
+ * stdout_begin - Prepare a writer for one message to standard output.
+ *
+ * This is the common start of _printf and _printf_ct: the call is checked
+ * against _printf_set_rate, and @out is set up to flush into the shared
+ * stdout sink, with a pending rate summary written first and hashing on
+ * when the sink suppresses repeats. Finish the message with
+ * fd_sink_commit(@out).
+ *
+ * @out: The writer to set up.
+ * @buffer: BUFF_SIZE bytes of staging buffer.
+ * @scratch: BUFF_SIZE bytes of conversion scratch space.
+ * @format: The call's format string, which identifies the call site.
+ *
+ * Return: 1 if the message should be formatted, 0 if the call is
+ * suppressed by rate limiting.
+ */
+int stdout_begin(writer_t *out, char *buffer, char *scratch,
+		const char *format)
+{
+	fd_sink_t *sink;
+
+	if (!rate_admit(format))
+		return (0);
+
+	sink = fd_sink_stdout();
+	writer_init(out, buffer, BUFF_SIZE, scratch, 1);
+	out->flush = fd_sink_flush;
+	out->ctx = sink;
+	rate_report(out);
+	out->hashing = __atomic_load_n(&sink->dedup, __ATOMIC_RELAXED);
+
+	return (1);
+}
+
+/**
+ * capture_callf - Record a call made without a va_list.
+ *
+ * The C++ front end passes its arguments here, promoted as for _printf,
+ * so that _printf_ct calls show up in a capture trace like _printf calls.
+ * It only calls this after seeing _printf_capture_on set, so calls made
+ * while capture is off build no va_list.
+ *
+ * @format: The format string.
+ */
+void capture_callf(const char *format, ...)
+{
+	va_list list;
+
+	va_start(list, format);
+	capture_call(format, list);
+	va_end(list);
+}
@@ -0,0 +1,104 @@
+#include "main.h"
+
+/**
+ * tee_sink_flush - Flush callback of tee sinks.
+ *
+ * The formatted bytes are appended to every destination that has not
+ * failed. Each destination buffers and flushes on its own terms, and a
+ * failed one is simply skipped, so it cannot hold up or break the rest.
+ * The tee itself fails only once every destination has.
+ *
+ * @out: The tee's writer.
+ *
+ * Return: 0 on success, -1 if every destination has failed.
+ */
+static int tee_sink_flush(writer_t *out)
+{
+	tee_sink_t *tee = out->ctx;
+	int i, alive = 0;
+
+	for (i = 0; i < tee->count; i++)
+	{
+		if (tee->to[i]->error)
+			continue;
+		writer_write(tee->to[i], out->buf, out->len);
+		if (!tee->to[i]->error)
+			alive++;
+	}
+	if (alive == 0 && tee->count > 0)
+		out->error = 1;
+	out->len = 0;
+
+	return (out->error ? -1 : 0);
+}
+
+/**
+ * tee_sink_open - Set up output that is formatted once for several sinks.
+ *
+ * Format into @tee->out with _wprintf, then call tee_sink_commit; the
+ * directives are parsed and converted once however many destinations
+ * the tee has, and no va_copy is needed.
+ *
+ * @tee: The tee to initialize; it starts with no destinations.
+ */
+void tee_sink_open(tee_sink_t *tee)
+{
+	writer_init(&tee->out, tee->buffer, BUFF_SIZE, tee->scratch, -1);
+	tee->out.flush = tee_sink_flush;
+	tee->out.ctx = tee;
+	tee->count = 0;
+}
+
+/**
+ * tee_sink_add - Add a destination to a tee.
+ *
+ * Any writer will do: the out member of an fd_sink_t, mmap_sink_t,
+ * lz_sink_t, mem_sink_t or callback_sink_t, or a writer of your own. The
+ * tee does not own it; close it after the tee's last commit.
+ *
+ * @tee: The tee.
+ * @to: The destination writer.
+ * @sync: Non-zero to flush @to at every commit, for destinations such as
+ * a terminal that should see each message at once; zero to let @to flush
+ * only when its own buffer fills.
+ *
+ * Return: 0 on success, -1 if the tee already has TEE_SINKS destinations.
+ */
+int tee_sink_add(tee_sink_t *tee, writer_t *to, int sync)
+{
+	if (to == NULL || tee->count == TEE_SINKS)
+		return (-1);
+
+	tee->to[tee->count] = to;
+	tee->sync[tee->count] = sync != 0;
+	tee->count++;
+
+	return (0);
+}
+
+/**
+ * tee_sink_commit - Hand the message formatted so far to every destination.
+ *
+ * Destinations added with @sync set are flushed as well. A destination
+ * that fails is left failed and skipped from then on; its error flag
+ * tells which one it was.
+ *
+ * @tee: The tee.
+ *
+ * Return: 0 on success, -1 if any destination has failed.
+ */
+int tee_sink_commit(tee_sink_t *tee)
+{
+	int i, status = 0;
+
+	writer_flush(&tee->out);
+	for (i = 0; i < tee->count; i++)
+	{
+		if (tee->sync[i])
+			writer_flush(tee->to[i]);
+		if (tee->to[i]->error)
+			status = -1;
+	}
+
+	return (status);
+}
@@ -0,0 +1,126 @@
+#include "check.h"
+#include <stdio.h>
+
+static int checks, failed;
+
+/**
+ * check_bytes - Compare output with what it should be.
+ *
+ * On a mismatch, up to CHECK_SHOW bytes of each are printed, starting a
+ * little before the first difference.
+ *
+ * @what: What is being checked, printed on failure.
+ * @got: The output.
+ * @got_len: Its length.
+ * @want: The expected output.
+ * @want_len: Its length.
+ *
+ * Return: 1 if they are equal, 0 otherwise.
+ */
+int check_bytes(const char *what, const char *got, long got_len,
+		const char *want, long want_len)
+{
+	long at = 0, from;
+
+	checks++;
+	while (at < got_len && at < want_len && got[at] == want[at])
+		at++;
+	if (at == got_len && at == want_len)
+		return (1);
+	failed++;
+	from = at > CHECK_SHOW / 4 ? at - CHECK_SHOW / 4 : 0;
+	fprintf(stderr, "FAIL %s: first difference at byte %ld\n"
+			"  got  (%ld) [%.*s]\n  want (%ld) [%.*s]\n", what, at,
+			got_len, (int)(got_len - from < CHECK_SHOW ?
+				got_len - from : CHECK_SHOW), got + from,
+			want_len, (int)(want_len - from < CHECK_SHOW ?
+				want_len - from : CHECK_SHOW), want + from);
+
+	return (0);
+}
+
+/**
+ * check_true - Count a condition as a check.
+ *
+ * @what: What is being checked, printed on failure.
+ * @cond: Non-zero if the check passed.
+ *
+ * Return: @cond.
+ */
+int check_true(const char *what, int cond)
+{
+	checks++;
+	if (!cond)
+	{
+		failed++;
+		fprintf(stderr, "FAIL %s\n", what);
+	}
+
+	return (cond);
+}
+
+/**
+ * check_glibc - Check that _wprintf formats like the C library.
+ *
+ * Both the output and the returned count must match vsnprintf's.
+ *
+ * @format: The format string, supported by both.
+ *
+ * Return: 1 if they agree, 0 otherwise.
+ */
+int check_glibc(const char *format, ...)
+{
+	static char got[CHECK_BUF], want[CHECK_BUF];
+	mem_sink_t sink;
+	va_list list, copy;
+	int n, m;
+
+	va_start(list, format);
+	va_copy(copy, list);
+	mem_sink_open(&sink, got, CHECK_BUF);
+	n = _vwprintf(&sink.out, format, list);
+	m = vsnprintf(want, CHECK_BUF, format, copy);
+	va_end(copy);
+	va_end(list);
+
+	return (check_bytes(format, got, sink.out.len, want, m) &&
+			check_true(format, n == m));
+}
+
+/**
+ * check_fmt - Check _wprintf's output and count against a fixed string.
+ *
+ * @want: The expected output.
+ * @format: The format string.
+ *
+ * Return: 1 if they agree, 0 otherwise.
+ */
+int check_fmt(const char *want, const char *format, ...)
+{
+	static char got[CHECK_BUF];
+	mem_sink_t sink;
+	va_list list;
+	int n;
+
+	va_start(list, format);
+	mem_sink_open(&sink, got, CHECK_BUF);
+	n = _vwprintf(&sink.out, format, list);
+	va_end(list);
+
+	return (check_bytes(format, got, sink.out.len, want, strlen(want)) &&
+			check_true(format, n == (int)strlen(want)));
+}
+
+/**
+ * check_done - Report the results of a test program.
+ *
+ * @name: The program's name.
+ *
+ * Return: The exit status: 0 if every check passed, 1 otherwise.
+ */
+int check_done(const char *name)
+{
+	fprintf(stderr, "%s: %d checks, %d failed\n", name, checks, failed);
+
+	return (failed ? 1 : 0);
+}
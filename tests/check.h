@@ -0,0 +1,26 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include "../main.h"
+
+/*
+ * Helpers shared by the test programs in tests/. Each check prints what
+ * it got and what it wanted when they differ, and check_done sums up.
+ */
+
+/* Room for the output of one check */
+#define CHECK_BUF 8192
+/* Bytes of mismatched output shown by a failed check */
+#define CHECK_SHOW 240
+
+int check_bytes(const char *what, const char *got, long got_len,
+		const char *want, long want_len);
+int check_true(const char *what, int cond);
+int check_glibc(const char *format, ...);
+int check_fmt(const char *want, const char *format, ...);
+int check_done(const char *name);
+char *check_slurp(const char *path, long *len);
+int check_file(const char *what, const char *path, const char *want,
+		long want_len);
+
+#endif
@@ -0,0 +1,70 @@
+#include "check.h"
+#include <fcntl.h>
+#include <stdlib.h>
+
+/**
+ * check_slurp - Read a whole file into memory, followed by a NUL byte.
+ *
+ * @path: The file.
+ * @len: Receives its length.
+ *
+ * Return: The contents, to be freed by the caller, or NULL on error.
+ */
+char *check_slurp(const char *path, long *len)
+{
+	long cap = 4096, got;
+	char *buf = malloc(cap), *more;
+	int fd = open(path, O_RDONLY);
+
+	*len = 0;
+	while (fd != -1 && buf != NULL)
+	{
+		if (*len == cap - 1)
+		{
+			more = realloc(buf, cap *= 2);
+			if (more == NULL)
+				break;
+			buf = more;
+		}
+		got = read(fd, buf + *len, cap - 1 - *len);
+		if (got < 0)
+			break;
+		if (got == 0)
+		{
+			close(fd);
+			buf[*len] = '\0';
+			return (buf);
+		}
+		*len += got;
+	}
+	if (fd != -1)
+		close(fd);
+	free(buf);
+
+	return (NULL);
+}
+
+/**
+ * check_file - Compare the contents of a file with what they should be.
+ *
+ * @what: What is being checked, printed on failure.
+ * @path: The file.
+ * @want: The expected contents.
+ * @want_len: Their length.
+ *
+ * Return: 1 if they are equal, 0 otherwise.
+ */
+int check_file(const char *what, const char *path, const char *want,
+		long want_len)
+{
+	long len;
+	char *got = check_slurp(path, &len);
+	int ok;
+
+	if (!check_true(what, got != NULL))
+		return (0);
+	ok = check_bytes(what, got, len, want, want_len);
+	free(got);
+
+	return (ok);
+}
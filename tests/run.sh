@@ -0,0 +1,70 @@
+#!/bin/sh
+#
+# run.sh - Build the library and run every test program against it.
+#
+#	sh tests/run.sh
+#
+# The library sources are compiled once with the tree's usual flags at
+# -O2, the level the stack bounds in main.h are stated for. Each
+# tests/test_*.c is linked with them and tests/check*.c and run from a
+# scratch directory, where it may create files and find the programs in
+# tools/, built there as well. Each tests/test_*.cpp is built the same
+# way with g++ in C++20 mode. Everything then runs a second time with
+# -DBUFF_SIZE=64, the low-stack mode, where every long conversion goes
+# through many flushes, and tests/test_profile.c once more against a
+# -DPRINTF_PROFILE build. The script exits non-zero if anything fails to
+# build or any check fails.
+
+cd "$(dirname "$0")/.." || exit 1
+CFLAGS="-O2 -Wall -Werror -Wextra -pedantic -std=gnu89"
+tmp=$(mktemp -d) || exit 1
+trap 'rm -rf "$tmp"' EXIT
+status=0
+
+# build <name> [flags...] - compile the library and tools into $tmp/<name>
+build()
+{
+	dir=$tmp/$1
+	shift
+	mkdir -p "$dir"
+	for src in $(ls *.c | grep -v '^main.c$') tests/check*.c; do
+		gcc $CFLAGS "$@" -I. -c "$src" \
+			-o "$dir/$(basename "$src" .c).o" || return 1
+	done
+	for src in tools/*.c; do
+		gcc $CFLAGS "$@" -I. "$src" "$dir"/*.o \
+			-o "$dir/$(basename "$src" .c)" -pthread || return 1
+	done
+}
+
+# run <name> [flags...] - link and run each of $tests against $tmp/<name>
+run()
+{
+	dir=$tmp/$1
+	shift
+	for src in $tests; do
+		bin=$dir/$(basename "$src" | tr . _)
+		case $src in
+		*.cpp)	cc="g++ -O2 -Wall -Werror -Wextra -std=c++20" ;;
+		*)	cc="gcc $CFLAGS" ;;
+		esac
+		if ! $cc "$@" -I. "$src" "$dir"/*.o -o "$bin" -pthread; then
+			status=1
+			continue
+		fi
+		(cd "$dir" && "$bin") || status=1
+	done
+}
+
+tests="tests/test_*.c tests/test_*.cpp"
+build lib || exit 1
+run lib
+echo "with -DBUFF_SIZE=64:" >&2
+build small -DBUFF_SIZE=64 || exit 1
+run small -DBUFF_SIZE=64
+echo "with -DPRINTF_PROFILE:" >&2
+tests=tests/test_profile.c
+build prof -DPRINTF_PROFILE || exit 1
+run prof -DPRINTF_PROFILE
+
+exit $status
@@ -0,0 +1,53 @@
+#include "check.h"
+#include <stdio.h>
+
+/*
+ * test_arena - _asprintf into an arena: results, lifetime until reset and
+ * running out of room.
+ */
+
+/**
+ * main - Run the checks.
+ *
+ * Return: 0 if all passed, 1 otherwise.
+ */
+int main(void)
+{
+	char mem[256], want[64], *s[8], *big;
+	arena_t arena;
+	size_t used;
+	int i, n;
+
+	arena_init(&arena, mem, sizeof(mem));
+	for (i = 0; i < 8; i++)
+	{
+		n = _asprintf(&arena, &s[i], "msg %d: %-6s|%#x", i, "ok",
+				(unsigned int)i * 17);
+		check_true("_asprintf length", n == (int)strlen(s[i]));
+	}
+	for (i = 0; i < 8; i++)
+	{
+		n = snprintf(want, sizeof(want), "msg %d: %-6s|%#x", i, "ok",
+				(unsigned int)i * 17);
+		check_bytes("string kept until reset", s[i], strlen(s[i]),
+				want, n);
+	}
+	check_true("strings are packed", s[1] == s[0] + strlen(s[0]) + 1);
+
+	used = arena.used;
+	check_true("too long fails", _asprintf(&arena, &big, "%300s", "x") ==
+			-1 && big == NULL && arena.used == used);
+	check_true("what fits still fits",
+			_asprintf(&arena, &big, "%s", "tail") == 4);
+
+	arena_reset(&arena);
+	check_true("reset reuses the memory",
+			_asprintf(&arena, &big, "%d", 42) == 2 && big == mem);
+	check_bytes("after reset", big, strlen(big), "42", 2);
+	check_true("fills exactly", _asprintf(&arena, &big, "%*d",
+				(int)(sizeof(mem) - arena.used - 1), 7) ==
+			(int)(sizeof(mem) - 4) && arena.used == sizeof(mem));
+	check_true("full arena fails", _asprintf(&arena, &big, "") == -1);
+
+	return (check_done("test_arena"));
+}
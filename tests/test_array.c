@@ -0,0 +1,86 @@
+#include "check.h"
+#include <limits.h>
+#include <stdio.h>
+
+/*
+ * test_array - The %[..] array conversion against the C library applied
+ * element by element.
+ */
+
+/**
+ * arr - Check an array directive against snprintf of each element.
+ * @dir: The array directive, e.g. "%5[d; ]".
+ * @elem: The same directive for one element, e.g. "%5d".
+ * @sep: The separator it should produce.
+ * @n: The element count.
+ * @a: The elements.
+ * @size: 'l' for long elements, 'h' for short ones, 0 for int.
+ */
+static void arr(const char *dir, const char *elem, const char *sep, int n,
+		const void *a, char size)
+{
+	static char want[CHECK_BUF];
+	int i, len = 0;
+
+	want[0] = '\0';
+	for (i = 0; i < n; i++)
+	{
+		if (i > 0)
+			len += snprintf(want + len, CHECK_BUF - len, "%s", sep);
+		if (size == 'l')
+			len += snprintf(want + len, CHECK_BUF - len, elem,
+					((const long *)a)[i]);
+		else if (size == 'h')
+			len += snprintf(want + len, CHECK_BUF - len, elem,
+					((const short *)a)[i]);
+		else
+			len += snprintf(want + len, CHECK_BUF - len, elem,
+					((const int *)a)[i]);
+	}
+	check_fmt(want, dir, n, a);
+}
+
+/**
+ * main - Run the checks.
+ *
+ * Return: 0 if all passed, 1 otherwise.
+ */
+int main(void)
+{
+	int ints[21] = {0, 1, -1, 7, -42, 1000, INT_MAX, INT_MIN, 99, -100000,
+		12345, 5, -5, 65535, 16, 255, 4096, -7, 3, 123456789, 8};
+	long longs[5] = {0, LONG_MAX, LONG_MIN, -1, 0x123456789aL};
+	short shorts[4] = {0, SHRT_MAX, SHRT_MIN, -2};
+	char mem[64];
+	mem_sink_t sink;
+
+	arr("%[d]", "%d", ", ", 21, ints, 0);
+	arr("%[i; ]", "%i", "; ", 21, ints, 0);
+	arr("%5[d|]", "%5d", "|", 21, ints, 0);
+	arr("%-6[d,]", "%-6d", ",", 9, ints, 0);
+	arr("%+[d ]", "%+d", " ", 21, ints, 0);
+	arr("% 05[d/]", "% 05d", "/", 12, ints, 0);
+	arr("%.3[d]", "%.3d", ", ", 21, ints, 0);
+	arr("%08.3[d]", "%08.3d", ", ", 6, ints, 0);
+	arr("%[u]", "%u", ", ", 21, ints, 0);
+	arr("%[x]", "%x", ", ", 21, ints, 0);
+	arr("%#[X:]", "%#X", ":", 21, ints, 0);
+	arr("%#010[x]", "%#010x", ", ", 16, ints, 0);
+	arr("%[o]", "%o", ", ", 21, ints, 0);
+	arr("%#[o]", "%#o", ", ", 21, ints, 0);
+	arr("%l[d]", "%ld", ", ", 5, longs, 'l');
+	arr("%l[x]", "%lx", ", ", 5, longs, 'l');
+	arr("%#l[o]", "%#lo", ", ", 5, longs, 'l');
+	arr("%h[d]", "%hd", ", ", 4, shorts, 'h');
+	arr("%h[u]", "%hu", ", ", 4, shorts, 'h');
+	arr("%[d]", "%d", ", ", 0, ints, 0);
+	arr("%[d]", "%d", ", ", 1, ints + 4, 0);
+
+	check_fmt("[1, -1] (null)", "[%[d]] %[d]", 2, ints + 1, 3, (int *)0);
+	mem_sink_open(&sink, mem, sizeof(mem));
+	check_true("%[d without ]", _wprintf(&sink.out, "%[d", 1, ints) == -1);
+	check_true("%[q]", _wprintf(&sink.out, "%[q]", 1, ints) == -1);
+	check_fmt("<7> <-42>", "<%[d> <]>", 2, ints + 3);
+
+	return (check_done("test_array"));
+}
@@ -0,0 +1,116 @@
+#include "check.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+/*
+ * test_batch - Records written together by batch_commit, larger batches
+ * than the buffer, records that fail, and batches on standard output.
+ */
+
+/**
+ * size_of - Get the size of a file.
+ * @path: The file.
+ *
+ * Return: Its size, or -1 if it cannot be read.
+ */
+static long size_of(const char *path)
+{
+	struct stat st;
+
+	return (stat(path, &st) == 0 ? (long)st.st_size : -1);
+}
+
+/**
+ * check_small - A batch that fits its buffer is written only on commit.
+ * @batch: The batch to use.
+ */
+static void check_small(batch_t *batch)
+{
+	static const char want[] = "id=0 ok\nid=1 ok\nid=2 ok\n";
+	int fd = open("test_batch.log", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	int i, ok = 1;
+
+	batch_init(batch, fd);
+	for (i = 0; i < 3; i++)
+		ok &= batch_add(batch, "id=%d %s\n", i, "ok") == 8;
+	check_true("records added", ok && batch->count == 3 &&
+			batch->lens[2] == 8);
+	check_true("nothing written before commit",
+			size_of("test_batch.log") == 0);
+	check_true("commit total", batch_commit(batch) == 24);
+	close(fd);
+	check_file("small batch", "test_batch.log", want, sizeof(want) - 1);
+}
+
+/**
+ * check_large - A batch bigger than BATCH_SIZE, with failed records.
+ * @batch: The batch to use.
+ */
+static void check_large(batch_t *batch)
+{
+	long cap = 4 * BATCH_SIZE, len = 0, total = 0;
+	char *want = malloc(cap);
+	int fd = open("test_batch.log", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	int i, n;
+
+	if (want == NULL)
+		return;
+	batch_init(batch, fd);
+	for (i = 0; len < 3 * BATCH_SIZE; i++)
+	{
+		n = batch_add(batch, "record %05d %-20s|\n", i, "payload");
+		len += snprintf(want + len, cap - len, "record %05d %-20s|\n",
+				i, "payload");
+		total += n;
+		if (i % 100 == 0 && batch_add(batch, "bad %[q]", 1, &i) != -1)
+			check_true("bad record fails", 0);
+	}
+	check_true("large commit", batch_commit(batch) >= 0);
+	close(fd);
+	check_true("lengths add up", total == len);
+	check_file("large batch", "test_batch.log", want, len);
+	free(want);
+}
+
+/**
+ * check_stdout - A batch on standard output stays in order with _printf.
+ * @batch: The batch to use.
+ */
+static void check_stdout(batch_t *batch)
+{
+	static const char want[] = "one\ntwo\n2b\nthree\n";
+	int fd = open("test_batch.out", O_RDWR | O_CREAT | O_TRUNC, 0644);
+	int saved = dup(1);
+
+	dup2(fd, 1);
+	_printf("one\n");
+	batch_init(batch, 1);
+	batch_add(batch, "two\n");
+	batch_add(batch, "%db\n", 2);
+	batch_commit(batch);
+	_printf("three\n");
+	fd_sink_drain(fd_sink_stdout());
+	dup2(saved, 1);
+	close(saved);
+	close(fd);
+	check_file("batch on stdout", "test_batch.out", want,
+			sizeof(want) - 1);
+}
+
+/**
+ * main - Run the checks.
+ *
+ * Return: 0 if all passed, 1 otherwise.
+ */
+int main(void)
+{
+	static batch_t batch;
+
+	check_small(&batch);
+	check_large(&batch);
+	check_stdout(&batch);
+
+	return (check_done("test_batch"));
+}
@@ -0,0 +1,142 @@
+#include "check.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <wchar.h>
+
+/*
+ * test_capture - _printf calls recorded with _printf_capture and played
+ * back by tools/pf_replay, which must reproduce the same output. Calls
+ * through a registered conversion are recorded without guessing its
+ * argument, and skipped on replay.
+ */
+
+/**
+ * calls - Make a set of _printf calls covering each kind of argument.
+ *
+ * Return: The number of characters printed.
+ */
+static long calls(void)
+{
+	static const int arr[] = {3, -1, 4, -1, 5};
+	long n = 0;
+	int i;
+
+	for (i = 0; i < 50; i++)
+	{
+		n += _printf("%d %s|%-6x|%c %lu%%\n", i, "str", (unsigned int)i,
+				'a' + i % 26, (unsigned long)i * 1000003);
+		n += _printf("%J %.2D %[d; ]\n", "say \"q\"", i * 101, 5, arr);
+	}
+	n += _printf("%s %ls %p\n", (char *)NULL, L"wide \x20ac", (void *)0);
+	n += _printf("%r %R %b %S\n", "abc", "Hello", 10u, "a\tb");
+
+	return (n);
+}
+
+/**
+ * quote - A registered conversion that takes no argument.
+ * @types: The arguments.
+ * @out: The writer.
+ * @spec: The directive.
+ *
+ * Return: 1.
+ */
+static int quote(va_list types, writer_t *out, const spec_t *spec)
+{
+	(void)types;
+	(void)spec;
+
+	return (writer_write(out, "Q", 1));
+}
+
+/**
+ * check_custom - Capture a call through a registered conversion.
+ */
+static void check_custom(void)
+{
+	static const char want[] = "Q abc def\nafter 1\n";
+	int out = open("test_capture.out", O_RDWR | O_CREAT | O_TRUNC, 0644);
+	int trace = open("test_capture.trace", O_RDWR | O_CREAT | O_TRUNC,
+			0644);
+	int saved = dup(1);
+	long len;
+	char *report;
+
+	_printf_register('Q', quote);
+	_printf_capture(trace);
+	dup2(out, 1);
+	_printf("%Q %s %s\n", "abc", "def");
+	_printf("after %d\n", 1);
+	fd_sink_drain(fd_sink_stdout());
+	dup2(saved, 1);
+	close(saved);
+	close(out);
+	_printf_capture(-1);
+	close(trace);
+	_printf_register('Q', NULL);
+	check_file("registered conversion", "test_capture.out", want,
+			sizeof(want) - 1);
+
+	check_true("replay with registered", system("./pf_replay -s mem "
+				"< test_capture.trace "
+				"2> test_capture.report") == 0);
+	report = check_slurp("test_capture.report", &len);
+	check_true("registered skipped", report != NULL &&
+			strncmp(report, "1 calls, 8 chars", 16) == 0 &&
+			strstr(report, "\n1 calls with registered conversions"
+				" skipped\n") != NULL);
+	free(report);
+}
+
+/**
+ * main - Run the checks.
+ *
+ * Return: 0 if all passed, 1 otherwise.
+ */
+int main(void)
+{
+	int out = open("test_capture.out", O_RDWR | O_CREAT | O_TRUNC, 0644);
+	int trace = open("test_capture.trace", O_RDWR | O_CREAT | O_TRUNC,
+			0644);
+	int saved = dup(1);
+	long printed, len, count = -1, chars = -1;
+	char *want, *head;
+
+	check_true("start", _printf_capture(trace) == 0);
+	dup2(out, 1);
+	printed = calls();
+	fd_sink_drain(fd_sink_stdout());
+	dup2(saved, 1);
+	close(saved);
+	close(out);
+	check_true("stop", _printf_capture(-1) == 0);
+	close(trace);
+
+	head = check_slurp("test_capture.trace", &len);
+	check_true("magic", head != NULL && len > CAPTURE_MAGIC_LEN &&
+			memcmp(head, CAPTURE_MAGIC, CAPTURE_MAGIC_LEN) == 0);
+	free(head);
+
+	check_true("replay", system("./pf_replay -s printf "
+				"< test_capture.trace > test_capture.replay "
+				"2> /dev/null") == 0);
+	want = check_slurp("test_capture.out", &len);
+	check_true("original length", want != NULL && len == printed);
+	if (want != NULL)
+		check_file("replayed output", "test_capture.replay", want, len);
+	free(want);
+
+	check_true("mem replay", system("./pf_replay -s mem -n 3 "
+				"< test_capture.trace "
+				"2> test_capture.report") == 0);
+	head = check_slurp("test_capture.report", &len);
+	if (head != NULL)
+		sscanf(head, "%ld calls, %ld chars", &count, &chars);
+	check_true("mem replay report", count == 3 * 102 &&
+			chars == 3 * printed);
+	free(head);
+	check_custom();
+
+	return (check_done("test_capture"));
+}
@@ -0,0 +1,148 @@
+#include "../printf.hpp"
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+
+extern "C" {
+#include "check.h"
+}
+
+/*
+ * test_ct - The compile-time front end of printf.hpp against the C
+ * library, and its output order with _printf on standard output.
+ */
+
+/**
+ * ct - Check _wprintf_ct<F> against snprintf with the same arguments.
+ * @args: The arguments; at least one, so snprintf gets a real call.
+ */
+template <printf_ct::fixed_string F, class... Args>
+static void ct(const Args &... args)
+{
+	static char got[CHECK_BUF], want[CHECK_BUF];
+	mem_sink_t sink;
+	int n, m;
+
+	mem_sink_open(&sink, got, CHECK_BUF);
+	n = _wprintf_ct<F>(&sink.out, args...);
+	m = std::snprintf(want, CHECK_BUF, F.str, args...);
+	check_bytes(F.str, got, sink.out.len, want, m);
+	check_true(F.str, n == m);
+}
+
+/**
+ * wide - Check _wprintf_ct<F> against _wprintf, which encodes %lc and %ls
+ * as UTF-8 itself, so no locale is needed.
+ * @args: The arguments.
+ */
+template <printf_ct::fixed_string F, class... Args>
+static void wide(const Args &... args)
+{
+	static char got[CHECK_BUF], want[CHECK_BUF];
+	mem_sink_t sink, ref;
+	int n, m;
+
+	mem_sink_open(&sink, got, CHECK_BUF);
+	mem_sink_open(&ref, want, CHECK_BUF);
+	n = _wprintf_ct<F>(&sink.out, args...);
+	m = _wprintf(&ref.out, F.str, printf_ct::c_arg(args)...);
+	check_bytes(F.str, got, sink.out.len, want, ref.out.len);
+	check_true(F.str, n == m);
+}
+
+/**
+ * check_utf8 - %lc writes the UTF-8 bytes of the character, not a
+ * truncated char.
+ */
+static void check_utf8()
+{
+	char got[16];
+	mem_sink_t sink;
+
+	mem_sink_open(&sink, got, sizeof(got));
+	_wprintf_ct<"[%lc]">(&sink.out, L'\u00e9');
+	check_bytes("%lc is UTF-8", got, sink.out.len, "[\xc3\xa9]", 4);
+}
+
+/**
+ * check_stdout - Mix _printf_ct and _printf on standard output.
+ */
+static void check_stdout()
+{
+	static const char want[] = "one 1\ntwo 2\nthree 3\n";
+	char got[64];
+	int fd = open("test_ct.out", O_RDWR | O_CREAT | O_TRUNC, 0644);
+	int saved = dup(1);
+	long n;
+
+	dup2(fd, 1);
+	_printf_ct<"one %d\n">(1);
+	_printf("two %d\n", 2);
+	_printf_ct<"%s %u\n">("three", 3u);
+	fd_sink_drain(fd_sink_stdout());
+	dup2(saved, 1);
+	close(saved);
+	n = pread(fd, got, sizeof(got), 0);
+	close(fd);
+	check_bytes("_printf_ct with _printf", got, n, want, sizeof(want) - 1);
+}
+
+/**
+ * check_capture - _printf_ct calls are recorded only while capture is on.
+ */
+static void check_capture()
+{
+	static const char format[] = "ct %d %s\n";
+	int fd = open("test_ct.trace", O_RDWR | O_CREAT | O_TRUNC, 0644);
+	int saved = dup(1), out = open("/dev/null", O_WRONLY);
+	long len;
+	char *trace;
+
+	dup2(out, 1);
+	_printf_capture(fd);
+	_printf_ct<"ct %d %s\n">(7, "x");
+	_printf_capture(-1);
+	_printf_ct<"off %d\n">(8);
+	fd_sink_drain(fd_sink_stdout());
+	dup2(saved, 1);
+	close(saved);
+	close(out);
+	close(fd);
+	trace = check_slurp("test_ct.trace", &len);
+	check_true("_printf_ct captured", trace != NULL &&
+			memmem(trace, len, format, sizeof(format) - 1) != NULL);
+	check_true("nothing captured when off", trace != NULL &&
+			memmem(trace, len, "off ", 4) == NULL);
+	free(trace);
+}
+
+/**
+ * main - Run the checks.
+ *
+ * Return: 0 if all passed, 1 otherwise.
+ */
+int main()
+{
+	ct<"%d|%i|%d|%d">(0, -1, INT_MAX, INT_MIN);
+	ct<"%ld|%ld|%lu|%hd">(LONG_MAX, LONG_MIN, ULONG_MAX, (short)-3);
+	ct<"[%5d][%-5d][%05d][%+d][% d][%.3d][%8.3d][%+.0d]">(42, 42, 42,
+			42, 42, 7, -7, 0);
+	ct<"%o|%#o|%x|%#x|%X|%#08x|%lx">(8u, 8u, 255u, 255u, 255u, 255u,
+			0xdeadbeefcafeUL);
+	ct<"[%c][%5c][%-5c]">('a', 'b', 'c');
+	ct<"[%s][%10s][%-10s][%.2s][%10.2s]">("hello", "hi", "hi", "hello",
+			"hello");
+	ct<"[%*d][%-*d][%.*d][%*.*s]">(6, 1, 6, 1, 3, 1, 6, 2, "abc");
+	ct<"[%p][%20p] 100%%">((void *)0x7ffe637541f0, (void *)0x1234);
+	wide<"[%lc][%3lc][%-3lc]">(L'\u00e9', L'x', (wint_t)0x20ac);
+	wide<"[%ls][%8ls][%-8ls][%.2ls]">(L"na\u00efve", L"\u20ac1",
+			L"ab", L"\u00e9t\u00e9");
+	ct<"[%lc][%ls]">(L'a', L"ascii");
+	check_utf8();
+	check_stdout();
+	check_capture();
+
+	return (check_done("test_ct"));
+}
@@ -0,0 +1,64 @@
+#include "check.h"
+#include <fcntl.h>
+#include <stdlib.h>
+
+/*
+ * test_dedup - Repeated _printf messages folded into "last message
+ * repeated N times" records on standard output.
+ */
+
+/**
+ * main - Run the checks.
+ *
+ * Return: 0 if all passed, 1 otherwise.
+ */
+int main(void)
+{
+	static const char want[] = "a\nlast message repeated 4 times\n"
+		"b\nlast message repeated 1 times\na\nn=1\nn=2\n"
+		"c\nlast message repeated 2 times\n";
+	int fd = open("test_dedup.out", O_RDWR | O_CREAT | O_TRUNC, 0644);
+	int saved = dup(1), i;
+	long len;
+	char *got;
+
+	dup2(fd, 1);
+	fd_sink_set_dedup(fd_sink_stdout(), 60);
+	for (i = 0; i < 5; i++)
+		_printf("a\n");
+	_printf("%c\n", 'b');
+	_printf("b\n");
+	_printf("a\n");
+	_printf("n=%d\n", 1);
+	_printf("n=%d\n", 2);
+	for (i = 0; i < 3; i++)
+		_printf("c\n");
+	fd_sink_set_dedup(fd_sink_stdout(), 0);
+	fd_sink_drain(fd_sink_stdout());
+	check_file("repeats folded", "test_dedup.out", want, sizeof(want) - 1);
+
+	lseek(fd, 0, SEEK_SET);
+	ftruncate(fd, 0);
+	fd_sink_set_dedup(fd_sink_stdout(), 60);
+	for (i = 0; i < 2; i++)
+		_printf("%*d\n", 2 * BUFF_SIZE, 7);
+	fd_sink_set_dedup(fd_sink_stdout(), 0);
+	fd_sink_drain(fd_sink_stdout());
+	got = check_slurp("test_dedup.out", &len);
+	check_true("long messages kept", got != NULL &&
+			len == 2 * (2 * BUFF_SIZE + 1) &&
+			strstr(got, "repeated") == NULL);
+	free(got);
+
+	lseek(fd, 0, SEEK_SET);
+	ftruncate(fd, 0);
+	_printf("x\n");
+	_printf("x\n");
+	fd_sink_drain(fd_sink_stdout());
+	check_file("off keeps repeats", "test_dedup.out", "x\nx\n", 4);
+	dup2(saved, 1);
+	close(saved);
+	close(fd);
+
+	return (check_done("test_dedup"));
+}
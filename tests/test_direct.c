@@ -0,0 +1,93 @@
+#include "check.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+/*
+ * test_direct - A direct_sink_t log file: flushes of partial blocks,
+ * appending after a reopen, and output larger than the sink's buffer.
+ * Where the file system refuses O_DIRECT the sink falls back to buffered
+ * I/O, and the output must be the same.
+ */
+
+#define DIRECT_TEXT (2 * DIRECT_SINK_BUF + 5000)
+
+/**
+ * size_of - Get the size of a file.
+ * @path: The file.
+ *
+ * Return: Its size, or -1 if it cannot be read.
+ */
+static long size_of(const char *path)
+{
+	struct stat st;
+
+	return (stat(path, &st) == 0 ? (long)st.st_size : -1);
+}
+
+/**
+ * check_tmpfs - Write through a sink on /dev/shm, if it exists. It is
+ * usually a tmpfs, which refuses O_DIRECT before Linux 6.6.
+ */
+static void check_tmpfs(void)
+{
+	static direct_sink_t sink;
+	char path[64];
+
+	sprintf(path, "/dev/shm/test_direct.%d", (int)getpid());
+	if (direct_sink_open(&sink, path) == -1)
+		return;
+	_wprintf(&sink.out, "on %s\n", "tmpfs");
+	check_true("tmpfs close", direct_sink_close(&sink) == 0);
+	check_file("tmpfs", path, "on tmpfs\n", 9);
+	unlink(path);
+}
+
+/**
+ * main - Run the checks.
+ *
+ * Return: 0 if all passed, 1 otherwise.
+ */
+int main(void)
+{
+	static direct_sink_t sink;
+	char *want = malloc(DIRECT_TEXT + 64);
+	long len = 0, n;
+
+	if (want == NULL)
+		return (1);
+	unlink("test_direct.log");
+	check_true("open", direct_sink_open(&sink, "test_direct.log") == 0);
+	check_true("aligned", sink.align >= 512 &&
+			(sink.align & (sink.align - 1)) == 0 &&
+			(long)sink.out.buf % sink.align == 0);
+	_wprintf(&sink.out, "first %s\n", "line");
+	len += sprintf(want + len, "first %s\n", "line");
+	writer_flush(&sink.out);
+	check_true("flushed partial block", size_of("test_direct.log") == len);
+	check_file("partial block", "test_direct.log", want, len);
+	_wprintf(&sink.out, "second %d\n", 2);
+	len += sprintf(want + len, "second %d\n", 2);
+	writer_flush(&sink.out);
+	check_file("rewritten block", "test_direct.log", want, len);
+	check_true("close", direct_sink_close(&sink) == 0);
+
+	check_true("reopen", direct_sink_open(&sink, "test_direct.log") == 0);
+	check_true("offset of the last block", sink.offset % sink.align == 0 &&
+			sink.offset + sink.out.len == len);
+	while (len < DIRECT_TEXT)
+	{
+		n = len;
+		_wprintf(&sink.out, "%08ld %-30s|\n", n, "appended");
+		len += sprintf(want + len, "%08ld %-30s|\n", n, "appended");
+	}
+	check_true("close after append", direct_sink_close(&sink) == 0);
+	check_true("size", size_of("test_direct.log") == len);
+	check_file("appended output", "test_direct.log", want, len);
+	fprintf(stderr, "test_direct: %s I/O, %d-byte blocks\n",
+			sink.direct ? "direct" : "buffered", sink.align);
+	free(want);
+	check_tmpfs();
+
+	return (check_done("test_direct"));
+}
@@ -0,0 +1,135 @@
+#define _GNU_SOURCE
+#include "check.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * test_fd_sink - An fd_sink_t on a small non-blocking pipe under each
+ * policy for a full queue.
+ */
+
+#define FD_PIPE 4096
+#define FD_TOTAL (FD_PIPE + FD_SINK_QUEUE + 20000)
+
+/**
+ * struct reader - A thread emptying the read end of a pipe.
+ * @fd: The read end.
+ * @buf: Where the bytes go, FD_TOTAL of them at most.
+ * @len: Bytes read so far.
+ * @slow: Non-zero to pause between reads, so the writer has to wait.
+ */
+struct reader
+{
+	int fd;
+	char *buf;
+	long len;
+	int slow;
+};
+
+/**
+ * drain - Read a pipe until it is empty or, for a thread, closed.
+ * @arg: A struct reader.
+ *
+ * Return: NULL.
+ */
+static void *drain(void *arg)
+{
+	struct reader *r = arg;
+	long got;
+
+	while (r->len < FD_TOTAL)
+	{
+		got = read(r->fd, r->buf + r->len, FD_TOTAL - r->len);
+		if (got <= 0)
+			break;
+		r->len += got;
+		if (r->slow)
+			usleep(200);
+	}
+
+	return (NULL);
+}
+
+/**
+ * run - Send FD_TOTAL bytes of numbered lines through an fd sink.
+ * @policy: The policy for a full queue.
+ * @sent: Receives the bytes sent.
+ * @r: Receives the bytes that came out of the pipe.
+ *
+ * Return: The number of bytes the sink reports as dropped.
+ */
+static long run(int policy, char *sent, struct reader *r)
+{
+	static fd_sink_t sink;
+	pthread_t thread;
+	long len = 0, dropped;
+	int fds[2], left;
+
+	if (pipe2(fds, O_NONBLOCK) == -1)
+		return (-1);
+	fcntl(fds[1], F_SETPIPE_SZ, FD_PIPE);
+	fd_sink_open(&sink, fds[1], policy, 5000);
+	r->fd = fds[0];
+	r->len = 0;
+	r->slow = policy == FD_SINK_WAIT;
+	if (r->slow)
+	{
+		fcntl(fds[0], F_SETFL, 0);
+		pthread_create(&thread, NULL, drain, r);
+	}
+	while (len < FD_TOTAL - 32)
+	{
+		_wprintf(&sink.out, "line %06ld\n", len);
+		len += snprintf(sent + len, FD_TOTAL - len, "line %06ld\n",
+				len);
+	}
+	writer_flush(&sink.out);
+	for (left = 1; !r->slow && left > 0; drain(r))
+		left = fd_sink_drain(&sink);
+	fd_sink_close(&sink);
+	close(fds[1]);
+	if (r->slow)
+		pthread_join(thread, NULL);
+	close(fds[0]);
+	dropped = fd_sink_dropped(&sink);
+	check_true("bytes conserved", r->len + dropped == len);
+
+	return (dropped);
+}
+
+/**
+ * main - Run the checks.
+ *
+ * Return: 0 if all passed, 1 otherwise.
+ */
+int main(void)
+{
+	char *sent = malloc(FD_TOTAL), *got = malloc(FD_TOTAL);
+	struct reader r;
+	long dropped, keep;
+
+	if (sent == NULL || got == NULL)
+		return (1);
+	r.buf = got;
+
+	dropped = run(FD_SINK_DROP_NEW, sent, &r);
+	check_true("DROP_NEW drops", dropped > 0);
+	check_bytes("DROP_NEW keeps the oldest bytes", got, r.len, sent,
+			r.len);
+
+	dropped = run(FD_SINK_DROP_OLD, sent, &r);
+	keep = FD_SINK_QUEUE;
+	check_true("DROP_OLD drops", dropped > 0 && r.len > keep);
+	check_bytes("DROP_OLD keeps the newest bytes", got + r.len - keep,
+			keep, sent + r.len + dropped - keep, keep);
+
+	dropped = run(FD_SINK_WAIT, sent, &r);
+	check_true("WAIT drops nothing", dropped == 0);
+	check_bytes("WAIT delivers everything", got, r.len, sent,
+			r.len + dropped);
+	free(sent);
+	free(got);
+
+	return (check_done("test_fd_sink"));
+}
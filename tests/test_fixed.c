@@ -0,0 +1,63 @@
+#include "check.h"
+#include <limits.h>
+#include <stdio.h>
+
+/*
+ * test_fixed - %D scaled integers against fixed strings and against the
+ * integer and fraction printed separately by the C library.
+ */
+
+/**
+ * fixed_glibc - Check %.<prec>ld of @n against snprintf of its parts.
+ * @n: The scaled integer.
+ * @prec: The number of decimals, 0 to 18.
+ */
+static void fixed_glibc(long n, int prec)
+{
+	char format[16], want[64];
+	unsigned long num = n < 0 ? 0 - (unsigned long)n : (unsigned long)n;
+	unsigned long scale = 1;
+	int i;
+
+	for (i = 0; i < prec; i++)
+		scale *= 10;
+	if (prec == 0)
+		snprintf(want, sizeof(want), "%ld", n);
+	else
+		snprintf(want, sizeof(want), "%s%lu.%0*lu",
+				n < 0 ? "-" : "", num / scale, prec,
+				num % scale);
+	snprintf(format, sizeof(format), "%%.%dlD", prec);
+	check_fmt(want, format, n);
+}
+
+/**
+ * main - Run the checks.
+ *
+ * Return: 0 if all passed, 1 otherwise.
+ */
+int main(void)
+{
+	static const long values[] = {0, 1, -1, 9, 10, 12345, -12345, 100000,
+		999999999L, LONG_MAX, LONG_MIN, LONG_MIN + 1};
+	unsigned int v;
+	int prec;
+
+	check_fmt("123.45|-0.05|0.05|0.000", "%.2D|%.2D|%.2D|%.3D", 12345,
+			-5, 5, 0);
+	check_fmt("42|-7|42", "%D|%.0D|%.D", 42, -7, 42);
+	check_fmt("+1.00| 0.5|-0123.45", "%+.2D|% .1D|%08.2D", 100, 5,
+			-12345);
+	check_fmt("1.5     |    0.01|-1.5", "%-8.1D|%8.2D|%-.1D", 15, 1, -15);
+	check_fmt("44.64|-1.23", "%.2hD|%.2hD", 70000, -123);
+	check_fmt("92233720368547758.07|-92233720368547758.08",
+			"%.2lD|%.2lD", LONG_MAX, LONG_MIN);
+	check_fmt("0.00000000000000000001", "%.20D", 1);
+	check_fmt("-0.000000000000000000012", "%.21D", -12);
+
+	for (v = 0; v < sizeof(values) / sizeof(values[0]); v++)
+		for (prec = 0; prec <= 18; prec += 3)
+			fixed_glibc(values[v], prec);
+
+	return (check_done("test_fixed"));
+}
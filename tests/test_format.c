@@ -0,0 +1,97 @@
+#include "check.h"
+#include <limits.h>
+
+/*
+ * test_format - The standard conversions, flags, width and precision
+ * against the C library.
+ */
+
+/**
+ * check_integers - Signed and unsigned decimal conversions.
+ */
+static void check_integers(void)
+{
+	check_glibc("%d|%i|%d|%d", 0, -1, INT_MAX, INT_MIN);
+	check_glibc("%ld|%ld|%li", LONG_MAX, LONG_MIN, -1L);
+	check_glibc("%hd|%hu|%hi", (short)-5, (unsigned short)65535,
+			(short)SHRT_MIN);
+	check_glibc("%u|%lu|%u", 3000000000u, ULONG_MAX, 0u);
+	check_glibc("[%5d][%-5d][%05d][%+d][% d][%+5d][%-+5d][% 05d]",
+			42, 42, 42, 42, 42, 42, 42, 42);
+	check_glibc("[%.3d][%8.3d][%-8.3d][%08.3d][%.0d][%5.0d][%+.0d]",
+			7, -7, 7, 7, 0, 0, 0);
+	check_glibc("[%+5.0d][%-+5.0d][% .0d][%+05.0d][%.0u][%5.0x]",
+			0, 0, 0, 0, 0u, 0u);
+	check_glibc("[%5u][%-5u][%05u][%.4u][%08.4u]", 1u, 1u, 1u, 1u, 1u);
+	check_glibc("[%*d][%-*d][%.*d][%*.*d][%.*d]", 6, 1, 6, 1, 3, 1,
+			6, 3, 1, -3, 5);
+}
+
+/**
+ * check_radix - Octal, hexadecimal and pointer conversions.
+ */
+static void check_radix(void)
+{
+	check_glibc("%o|%#o|%x|%#x|%X|%#X", 8u, 8u, 255u, 255u, 255u, 255u);
+	check_glibc("[%#08x][%#-8x][%.5x][%#.5o][%08X]",
+			255u, 255u, 255u, 8u, 255u);
+	check_glibc("%#x|%#o|%x|%.0x|%#.0o", 0u, 0u, 0u, 0u, 0u);
+	check_glibc("%lx|%lo|%lX|%#lx", 0xdeadbeefcafeUL, 01234567UL,
+			ULONG_MAX, 1UL);
+	check_glibc("%hx|%ho", (unsigned short)0xbeef, (unsigned short)0777);
+	check_glibc("[%p][%20p][%-20p][%p]", (void *)0x7ffe637541f0,
+			(void *)0x1234, (void *)0x1234, (void *)0);
+}
+
+/**
+ * check_text - Characters, strings, percent signs and odd directives.
+ */
+static void check_text(void)
+{
+	check_glibc("[%c][%5c][%-5c]", 'a', 'b', 'c');
+	check_glibc("%c", 0);
+	check_glibc("[%s][%10s][%-10s][%.2s][%10.2s][%-10.2s][%s]", "hello",
+			"hi", "hi", "hello", "hello", "hello", "");
+	check_glibc("[%.*s][%*s]", 3, "abcdef", 4, "ab");
+	check_glibc("%s", (char *)0);
+	check_glibc("%%|100%%|%d%%", 5);
+	check_glibc("plain text, no directives");
+	check_glibc("");
+	check_glibc("%y|%5y");
+	check_fmt("olleh", "%r", "hello");
+	check_fmt("uryyb", "%R", "hello");
+	check_fmt("101", "%b", 5u);
+	check_fmt("a\\x01b\\x7F", "%S", "a\001b\177");
+}
+
+/**
+ * check_long_output - Output longer than the staging buffer and padding
+ * wider than the scratch space.
+ */
+static void check_long_output(void)
+{
+	static char text[3 * BUFF_SIZE];
+
+	memset(text, 'q', sizeof(text) - 1);
+	check_glibc("<%s>", text);
+	check_glibc("<%.*s>", BUFF_SIZE + 3, text);
+	check_glibc("<%*d>", 2 * BUFF_SIZE + 5, -12);
+	check_glibc("<%-*s>", 2 * BUFF_SIZE + 5, "x");
+	check_glibc("<%.*d>", BUFF_SIZE + 7, 42);
+	check_glibc("<%#.*x>", BUFF_SIZE + 7, 42u);
+}
+
+/**
+ * main - Run the checks.
+ *
+ * Return: 0 if all passed, 1 otherwise.
+ */
+int main(void)
+{
+	check_integers();
+	check_radix();
+	check_text();
+	check_long_output();
+
+	return (check_done("test_format"));
+}
@@ -0,0 +1,37 @@
+#include "check.h"
+
+/*
+ * test_json - %J escaping, NULL, precision on UTF-8 boundaries and width.
+ */
+
+/**
+ * main - Run the checks.
+ *
+ * Return: 0 if all passed, 1 otherwise.
+ */
+int main(void)
+{
+	check_fmt("\"plain\"", "%J", "plain");
+	check_fmt("\"\"", "%J", "");
+	check_fmt("\"say \\\"hi\\\" \\\\ bye\"", "%J", "say \"hi\" \\ bye");
+	check_fmt("\"a\\nb\\tc\\rd\\be\\ff\"", "%J", "a\nb\tc\rd\be\ff");
+	check_fmt("\"\\u0001\\u001f\\u000b\x7f\"", "%J", "\001\037\013\177");
+	check_fmt("\"caf\xc3\xa9 \xe2\x82\xac\"", "%J",
+			"caf\xc3\xa9 \xe2\x82\xac");
+	check_fmt("{\"k\": \"0123456789abcdefghij\\\"klmnopqrstuvwxyz\\n\"}",
+			"{\"k\": %J}",
+			"0123456789abcdefghij\"klmnopqrstuvwxyz\n");
+	check_fmt("null|null|  null", "%J|%.2J|%6J", (char *)NULL,
+			(char *)NULL, (char *)NULL);
+
+	check_fmt("\"caf\"", "%.4J", "caf\xc3\xa9");
+	check_fmt("\"caf\xc3\xa9\"", "%.5J", "caf\xc3\xa9!");
+	check_fmt("\"\"", "%.2J", "\xe2\x82\xac");
+	check_fmt("\"a\\n\"", "%.2J", "a\nb");
+
+	check_fmt("[   \"a\\n\"][\"a\\n\"   ]", "[%8J][%-8J]", "a\n", "a\n");
+	check_fmt("[\"too long\"]", "[%4J]", "too long");
+	check_fmt("[   \"ab\"]", "[%7.2J]", "abcdef");
+
+	return (check_done("test_json"));
+}
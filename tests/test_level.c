@@ -0,0 +1,72 @@
+#define PRINTF_MIN_LEVEL PRINTF_WARN
+#include "check.h"
+#include <fcntl.h>
+
+/*
+ * test_level - The leveled front ends: levels compiled out, levels turned
+ * off at run time, and arguments of disabled calls left unevaluated.
+ * This file is built with PRINTF_MIN_LEVEL at PRINTF_WARN.
+ */
+
+static int evaluated;
+
+/**
+ * touch - An argument whose evaluation is counted.
+ * @n: The value to return.
+ *
+ * Return: @n.
+ */
+static int touch(int n)
+{
+	evaluated++;
+
+	return (n);
+}
+
+/**
+ * main - Run the checks.
+ *
+ * Return: 0 if all passed, 1 otherwise.
+ */
+int main(void)
+{
+	static const char want[] = "warn 1\nerror 2\nerror 4\nelse\nwarn 6\n";
+	int fd = open("test_level.out", O_RDWR | O_CREAT | O_TRUNC, 0644);
+	int saved = dup(1);
+
+	check_true("bad level", _printf_set_level(PRINTF_ERROR + 1) == -1 &&
+			_printf_set_level(-1) == -1);
+	check_true("default level", _printf_set_level(PRINTF_DEBUG) ==
+			PRINTF_DEBUG);
+
+	dup2(fd, 1);
+	_printf_debug("debug %d\n", touch(0));
+	_printf_info("info %d\n", touch(0));
+	_printf_warn("warn %d\n", touch(1));
+	_printf_error("error %d\n", touch(2));
+	check_true("compiled out", evaluated == 2);
+
+	check_true("previous level", _printf_set_level(PRINTF_ERROR) ==
+			PRINTF_DEBUG);
+	_printf_warn("warn %d\n", touch(3));
+	_printf_error("error %d\n", touch(4));
+	check_true("turned off", evaluated == 3);
+
+	if (evaluated == 3)
+		_printf_warn("warn %d\n", touch(5));
+	if (evaluated != 3)
+		_printf_error("error %d\n", touch(5));
+	else
+		_printf("else\n");
+	check_true("else binding", evaluated == 3);
+
+	_printf_set_level(PRINTF_WARN);
+	_printf_warn("warn %d\n", touch(6));
+	fd_sink_drain(fd_sink_stdout());
+	dup2(saved, 1);
+	close(saved);
+	close(fd);
+	check_file("printed lines", "test_level.out", want, sizeof(want) - 1);
+
+	return (check_done("test_level"));
+}
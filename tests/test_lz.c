@@ -0,0 +1,146 @@
+#include "check.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * test_lz - lz_compress round trips, and an lz_sink_t stream decoded frame
+ * by frame back to the text that was formatted into it.
+ */
+
+#define LZ_TEXT (5 * LZ_SINK_BLOCK)
+
+/**
+ * get32 - Decode a 4-byte little-endian number.
+ * @p: The bytes.
+ *
+ * Return: The number.
+ */
+static unsigned long get32(const char *p)
+{
+	const unsigned char *u = (const unsigned char *)p;
+
+	return (u[0] | u[1] << 8 | (unsigned long)u[2] << 16 |
+			(unsigned long)u[3] << 24);
+}
+
+/**
+ * round_trip - Compress and decompress a block and compare.
+ * @what: What is checked.
+ * @src: The block.
+ * @n: Its length.
+ */
+static void round_trip(const char *what, const char *src, int n)
+{
+	char *packed = malloc(LZ_BOUND(n)), *back = malloc(n + 1);
+	int len, got;
+
+	if (packed == NULL || back == NULL)
+		return;
+	len = lz_compress(src, n, packed);
+	got = lz_decompress(packed, len, back, n);
+	check_true(what, len >= 0 && len <= LZ_BOUND(n) && got == n);
+	check_bytes(what, back, got < 0 ? 0 : got, src, n);
+	free(packed);
+	free(back);
+}
+
+/**
+ * unpack - Decode an lz_sink_t stream.
+ * @in: The stream.
+ * @len: Its length.
+ * @dst: Receives the original bytes.
+ * @cap: Room in @dst.
+ * @raw_frames: Receives the number of frames stored uncompressed.
+ *
+ * Return: The number of bytes decoded, or -1 if the stream is malformed.
+ */
+static long unpack(const char *in, long len, char *dst, long cap,
+		int *raw_frames)
+{
+	long pos = LZ_MAGIC_LEN, done = 0;
+	unsigned long raw, stored;
+
+	*raw_frames = 0;
+	if (len < LZ_MAGIC_LEN || memcmp(in, LZ_MAGIC, LZ_MAGIC_LEN) != 0)
+		return (-1);
+	while (pos + LZ_FRAME_HDR <= len)
+	{
+		raw = get32(in + pos);
+		stored = get32(in + pos + 4) & 0x7FFFFFFFUL;
+		if (raw == 0)
+			return (pos + LZ_FRAME_HDR == len ? done : -1);
+		if (pos + LZ_FRAME_HDR + (long)stored > len ||
+				done + (long)raw > cap)
+			return (-1);
+		if (in[pos + 7] & 0x80)
+		{
+			if (stored != raw)
+				return (-1);
+			memcpy(dst + done, in + pos + LZ_FRAME_HDR, raw);
+			*raw_frames += 1;
+		}
+		else if (lz_decompress(in + pos + LZ_FRAME_HDR, stored,
+					dst + done, raw) != (int)raw)
+			return (-1);
+		done += raw;
+		pos += LZ_FRAME_HDR + stored;
+	}
+
+	return (-1);
+}
+
+/**
+ * main - Run the checks.
+ *
+ * Return: 0 if all passed, 1 otherwise.
+ */
+int main(void)
+{
+	static const char line[] = "%06ld level=info msg=%s id=%lx\n";
+	static lz_sink_t sink;
+	char *want = malloc(LZ_TEXT + 64), *got = malloc(LZ_TEXT + 64);
+	char *noise = malloc(LZ_SINK_BLOCK), *file;
+	unsigned long seed = 1;
+	long len = 0, n, flen;
+	int fd = open("test_lz.out", O_RDWR | O_CREAT | O_TRUNC, 0644);
+	int i, raw_frames = 0;
+
+	if (want == NULL || got == NULL || noise == NULL)
+		return (1);
+	for (i = 0; i < LZ_SINK_BLOCK; i++)
+		noise[i] = (char)((seed = seed * 1103515245 + 12345) >> 16);
+	round_trip("empty", "", 0);
+	round_trip("one byte", "x", 1);
+	round_trip("short", "abcabcabcabcabcabcabcabcabcabc", 30);
+	round_trip("noise", noise, LZ_SINK_BLOCK);
+
+	lz_sink_open(&sink, fd);
+	while (len < LZ_TEXT - LZ_SINK_BLOCK)
+	{
+		n = len;
+		_wprintf(&sink.out, line, n, "request served", n * 7919);
+		len += snprintf(want + len, 64, line, n, "request served",
+				n * 7919);
+	}
+	writer_write(&sink.out, noise, LZ_SINK_BLOCK - 1000);
+	memcpy(want + len, noise, LZ_SINK_BLOCK - 1000);
+	len += LZ_SINK_BLOCK - 1000;
+	check_true("close", lz_sink_close(&sink) == 0);
+	close(fd);
+
+	file = check_slurp("test_lz.out", &flen);
+	n = file == NULL ? -1 : unpack(file, flen, got, LZ_TEXT + 64,
+			&raw_frames);
+	check_bytes("stream decodes", got, n < 0 ? 0 : n, want, len);
+	check_true("noise stored raw", raw_frames >= 1);
+	check_true("byte counts", sink.raw_bytes == (unsigned long)len &&
+			sink.packed_bytes == (unsigned long)flen);
+	check_true("text compresses", flen < len / 2);
+	free(file);
+	free(want);
+	free(got);
+	free(noise);
+
+	return (check_done("test_lz"));
+}
@@ -0,0 +1,52 @@
+#include "check.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+/*
+ * test_mmap - Output through an mmap_sink_t, across mapping windows and
+ * appended to an existing file.
+ */
+
+#define MMAP_LINES 400000
+#define MMAP_FORMAT "%06ld %-20s|%#x|%+d\n"
+#define MMAP_ARGS(i) (i), "mapped line", (unsigned int)(i) * 2654435761u, \
+	(int)((i) % 1000) - 500
+
+/**
+ * main - Run the checks.
+ *
+ * Return: 0 if all passed, 1 otherwise.
+ */
+int main(void)
+{
+	static mmap_sink_t sink;
+	long cap = MMAP_LINES * 64L + 64, len = 0, i;
+	char *want = malloc(cap);
+	struct stat st;
+
+	unlink("test_mmap.log");
+	if (!check_true("mmap_sink_open", want != NULL &&
+				mmap_sink_open(&sink, "test_mmap.log") == 0))
+		return (check_done("test_mmap"));
+	for (i = 0; i < MMAP_LINES; i++)
+	{
+		_wprintf(&sink.out, MMAP_FORMAT, MMAP_ARGS(i));
+		len += snprintf(want + len, cap - len, MMAP_FORMAT,
+				MMAP_ARGS(i));
+	}
+	check_true("MMAP_LINES cross a window", len > MMAP_SINK_CHUNK);
+	check_true("mmap_sink_close", mmap_sink_close(&sink) == 0);
+	check_file("file after close", "test_mmap.log", want, len);
+
+	check_true("reopen", mmap_sink_open(&sink, "test_mmap.log") == 0);
+	_wprintf(&sink.out, "appended %s\n", "line");
+	check_true("close again", mmap_sink_close(&sink) == 0);
+	len += snprintf(want + len, cap - len, "appended line\n");
+	check_file("file after append", "test_mmap.log", want, len);
+	check_true("file size", stat("test_mmap.log", &st) == 0 &&
+			st.st_size == len);
+	free(want);
+
+	return (check_done("test_mmap"));
+}
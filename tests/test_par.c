@@ -0,0 +1,115 @@
+#include "check.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * test_par - par_format output against the records formatted one by one,
+ * for several worker counts, on a file and on standard output.
+ */
+
+#define PAR_COUNT (10 * PAR_CHUNK + 17)
+#define PAR_LINE "%06ld %-12s|%#lx\n"
+
+/**
+ * struct rec - A record to format.
+ * @id: A number.
+ * @name: A string.
+ */
+struct rec
+{
+	long id;
+	const char *name;
+};
+
+/**
+ * format_rec - Format one record.
+ * @out: The writer.
+ * @record: A struct rec.
+ *
+ * Return: The number of characters produced, or -1 for the bad record.
+ */
+static int format_rec(writer_t *out, const void *record)
+{
+	const struct rec *r = record;
+
+	if (r->name == NULL)
+		return (-1);
+
+	return (_wprintf(out, PAR_LINE, r->id, r->name, r->id * 31));
+}
+
+/**
+ * par_file - Run par_format into a file and compare it with @want.
+ * @recs: The records.
+ * @threads: The number of workers.
+ * @want: The expected output.
+ * @len: Its length.
+ */
+static void par_file(struct rec *recs, int threads, const char *want,
+		long len)
+{
+	char what[32];
+	int fd = open("test_par.out", O_RDWR | O_CREAT | O_TRUNC, 0644);
+	long n = par_format(fd, recs, sizeof(*recs), PAR_COUNT, format_rec,
+			threads);
+
+	close(fd);
+	sprintf(what, "%d threads", threads);
+	check_true(what, n == len);
+	check_file(what, "test_par.out", want, len);
+}
+
+/**
+ * main - Run the checks.
+ *
+ * Return: 0 if all passed, 1 otherwise.
+ */
+int main(void)
+{
+	static const char *names[] = {"alpha", "b", "a longer name", ""};
+	struct rec *recs = malloc(PAR_COUNT * sizeof(*recs));
+	char *want = malloc(PAR_COUNT * 64);
+	long len = 0, i;
+	int fd, saved;
+
+	if (recs == NULL || want == NULL)
+		return (1);
+	for (i = 0; i < PAR_COUNT; i++)
+	{
+		recs[i].id = i * 7;
+		recs[i].name = names[i % 4];
+		len += sprintf(want + len, PAR_LINE, recs[i].id, recs[i].name,
+				recs[i].id * 31);
+	}
+	par_file(recs, 1, want, len);
+	par_file(recs, 2, want, len);
+	par_file(recs, 4, want, len);
+	par_file(recs, 0, want, len);
+	check_true("no records", par_format(2, recs, sizeof(*recs), 0,
+				format_rec, 4) == 0);
+
+	fd = open("test_par.out", O_RDWR | O_CREAT | O_TRUNC, 0644);
+	saved = dup(1);
+	dup2(fd, 1);
+	_printf("head\n");
+	par_format(1, recs, sizeof(*recs), 3, format_rec, 2);
+	_printf("tail\n");
+	fd_sink_drain(fd_sink_stdout());
+	dup2(saved, 1);
+	close(saved);
+	close(fd);
+	len = sprintf(want, "head\n" PAR_LINE PAR_LINE PAR_LINE "tail\n", 0L,
+			names[0], 0L, 7L, names[1], 217L, 14L, names[2], 434L);
+	check_file("in order on stdout", "test_par.out", want, len);
+
+	recs[5 * PAR_CHUNK].name = NULL;
+	fd = open("test_par.out", O_RDWR | O_CREAT | O_TRUNC, 0644);
+	check_true("bad record fails", par_format(fd, recs, sizeof(*recs),
+				PAR_COUNT, format_rec, 4) == -1);
+	close(fd);
+	free(recs);
+	free(want);
+
+	return (check_done("test_par"));
+}
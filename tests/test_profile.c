@@ -0,0 +1,55 @@
+#include "check.h"
+#include <fcntl.h>
+#include <stdlib.h>
+
+/*
+ * test_profile - The per-conversion profile written by prof_dump. In a
+ * PRINTF_PROFILE build the counts and bytes of known calls must show up;
+ * in any other build the profile must be empty.
+ */
+
+/**
+ * main - Run the checks.
+ *
+ * Return: 0 if all passed, 1 otherwise.
+ */
+int main(void)
+{
+	int fd = open("test_profile.err", O_RDWR | O_CREAT | O_TRUNC, 0644);
+	int saved = dup(2), i, status;
+	char mem[512];
+	mem_sink_t sink;
+	long len;
+	char *got;
+
+	for (i = 0; i < 10; i++)
+	{
+		mem_sink_open(&sink, mem, sizeof(mem));
+		_wprintf(&sink.out, "%d|%s|%5x\n", i, "abc", 255u);
+	}
+	dup2(fd, 2);
+	prof_dump();
+	dup2(saved, 2);
+	got = check_slurp("test_profile.err", &len);
+	if (got == NULL)
+		return (1);
+#ifdef PRINTF_PROFILE
+	check_true("%d counted", strstr(got, "convert d: 10 calls, 10 bytes,")
+			!= NULL);
+	check_true("%s counted", strstr(got, "convert s: 10 calls, 30 bytes,")
+			!= NULL);
+	check_true("%x counted", strstr(got, "convert x: 10 calls, 50 bytes,")
+			!= NULL);
+	check_true("parse counted", strstr(got, "parse ") != NULL);
+	check_true("histogram", strstr(got, " <") != NULL);
+#else
+	check_true("no profile", len == 0);
+#endif
+	free(got);
+	status = check_done("test_profile");
+	/* The profile dumped again at exit is not wanted on the terminal */
+	dup2(fd, 2);
+	close(fd);
+
+	return (status);
+}
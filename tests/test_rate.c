@@ -0,0 +1,70 @@
+#include "check.h"
+#include <fcntl.h>
+#include <stdlib.h>
+
+/*
+ * test_rate - Sampling and rate limiting of _printf call sites, the
+ * summary of suppressed calls, and bad settings.
+ */
+
+/**
+ * main - Run the checks.
+ *
+ * Return: 0 if all passed, 1 otherwise.
+ */
+int main(void)
+{
+	static const char want[] = "sample 0\nsample 3\nsample 6\n"
+		"limit ok\nlimit ok\nlimit ok\nlimit ok\n";
+	int fd = open("test_rate.out", O_RDWR | O_CREAT | O_TRUNC, 0644);
+	int saved = dup(1), i, ok = 1;
+	long len;
+	char *got, *samples, *limits, *after;
+
+	check_true("bad mode", _printf_set_rate(5, 1, 1) == -1);
+	check_true("zero rate", _printf_set_rate(RATE_LIMIT, 0, 1) == -1);
+	check_true("zero burst", _printf_set_rate(RATE_LIMIT, 1, 0) == -1);
+	check_true("zero period", _printf_set_rate(RATE_SAMPLE, 0, 0) == -1);
+
+	dup2(fd, 1);
+	_printf_set_rate(RATE_SAMPLE, 3, 0);
+	for (i = 0; i < 9; i++)
+		ok &= _printf("sample %d\n", i) == (i % 3 ? 0 : 9);
+	check_true("one in three", ok);
+	_printf_set_rate(RATE_LIMIT, 1, 4);
+	for (i = 0; i < 20; i++)
+		ok &= _printf("limit %s\n", "ok") == (i < 4 ? 9 : 0);
+	check_true("burst of four", ok);
+	check_true("arguments untouched", _printf("limit %s\n",
+				(char *)1) == 0);
+	fd_sink_drain(fd_sink_stdout());
+	check_file("admitted lines", "test_rate.out", want, sizeof(want) - 1);
+
+	sleep(RATE_REPORT_SEC);
+	_printf("after\n");
+	_printf_set_rate(RATE_OFF, 0, 0);
+	for (i = 0; i < 3; i++)
+		ok &= _printf("off\n") == 4;
+	check_true("off prints everything", ok);
+	fd_sink_drain(fd_sink_stdout());
+	dup2(saved, 1);
+	close(saved);
+	close(fd);
+
+	got = check_slurp("test_rate.out", &len);
+	if (got == NULL)
+		return (1);
+	samples = strstr(got, "_printf: suppressed 6 calls of "
+			"\"sample %d\\n\"\n");
+	limits = strstr(got, "_printf: suppressed 17 calls of "
+			"\"limit %s\\n\"\n");
+	after = strstr(got, "after\noff\noff\noff\n");
+	check_true("summary of samples", samples != NULL);
+	check_true("summary of limits", limits != NULL);
+	check_true("summary before the call", after != NULL &&
+			after > samples && after > limits &&
+			after + 18 == got + len);
+	free(got);
+
+	return (check_done("test_rate"));
+}
@@ -0,0 +1,84 @@
+#include "check.h"
+
+/*
+ * test_register - Custom conversions installed with _printf_register.
+ */
+
+/**
+ * print_money - A custom conversion: an int number of cents as "$d.cc",
+ * honouring the width.
+ * @types: The arguments.
+ * @out: The writer.
+ * @spec: The directive.
+ *
+ * Return: The number of characters printed.
+ */
+static int print_money(va_list types, writer_t *out, const spec_t *spec)
+{
+	int cents = va_arg(types, int), n = 0;
+	char text[32];
+	mem_sink_t sink;
+
+	mem_sink_open(&sink, text, sizeof(text));
+	_wprintf(&sink.out, "$%d.%.2d", cents / 100, cents % 100);
+	if (!(spec->flags & F_MINUS))
+		n += writer_pad(out, ' ', spec->width - sink.out.len);
+	n += writer_write(out, text, sink.out.len);
+	if (spec->flags & F_MINUS)
+		n += writer_pad(out, ' ', spec->width - sink.out.len);
+
+	return (n);
+}
+
+/**
+ * print_shout - Replaces %s: the string in upper case.
+ * @types: The arguments.
+ * @out: The writer.
+ * @spec: The directive.
+ *
+ * Return: The number of characters printed.
+ */
+static int print_shout(va_list types, writer_t *out, const spec_t *spec)
+{
+	const char *s = va_arg(types, const char *);
+	int n = 0;
+	char c;
+
+	(void)spec;
+	for (; *s; s++, n++)
+	{
+		c = *s >= 'a' && *s <= 'z' ? *s - 'a' + 'A' : *s;
+		writer_write(out, &c, 1);
+	}
+
+	return (n);
+}
+
+/**
+ * main - Run the checks.
+ *
+ * Return: 0 if all passed, 1 otherwise.
+ */
+int main(void)
+{
+	check_fmt("%m", "%m");
+	check_true("register m", _printf_register('m', print_money) == 0);
+	check_fmt("total $12.05, tax [   $0.99][$3.00   ]",
+			"total %m, tax [%8m][%-8m]", 1205, 99, 300);
+	check_fmt("7 $1.00 x", "%d %m %s", 7, 100, "x");
+
+	check_true("override s", _printf_register('s', print_shout) == 0);
+	check_fmt("HELLO, WORLD", "%s, %c%s", "hello", 'W', "orld");
+	check_true("restore s", _printf_register('s', NULL) == 0);
+	check_fmt("hello", "%s", "hello");
+	check_true("remove m", _printf_register('m', NULL) == 0);
+	check_fmt("%m", "%m");
+
+	check_true("reject digit", _printf_register('5', print_money) == -1);
+	check_true("reject flag", _printf_register('-', print_money) == -1);
+	check_true("reject size", _printf_register('l', print_money) == -1);
+	check_true("reject array", _printf_register('[', print_money) == -1);
+	check_fmt("5", "%d", 5);
+
+	return (check_done("test_register"));
+}
@@ -0,0 +1,119 @@
+#include "check.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+
+/*
+ * test_sigsafe - The signal-safe variants against the C library, from a
+ * signal handler, %D, and their refusal of unsafe conversions.
+ */
+
+static int handler_ret;
+
+/**
+ * sig_glibc - Check _vdprintf_sigsafe against vsnprintf through a 16-byte
+ * buffer, so the output is written in many pieces.
+ * @format: The format string.
+ */
+static void sig_glibc(const char *format, ...)
+{
+	char buf[16], want[CHECK_BUF];
+	va_list list, copy;
+	int fd = open("test_sigsafe.out", O_RDWR | O_CREAT | O_TRUNC, 0644);
+	int n, m;
+
+	va_start(list, format);
+	va_copy(copy, list);
+	n = _vdprintf_sigsafe(fd, buf, sizeof(buf), format, list);
+	m = vsnprintf(want, CHECK_BUF, format, copy);
+	va_end(copy);
+	va_end(list);
+	close(fd);
+	check_file(format, "test_sigsafe.out", want, m);
+	check_true(format, n == m);
+}
+
+/**
+ * check_fixed - Check %D through a 16-byte buffer. vsnprintf has no %D to
+ * compare with, so the output is fixed.
+ */
+static void check_fixed(void)
+{
+	static const char want[] = "[123.45][-000.005][+1.500000]";
+	char buf[16];
+	int fd = open("test_sigsafe.out", O_RDWR | O_CREAT | O_TRUNC, 0644);
+	int n;
+
+	n = _dprintf_sigsafe(fd, buf, sizeof(buf), "[%.2D][%08.3lD][%+.6D]",
+			12345, -5L, 1500000);
+	close(fd);
+	check_file("%D", "test_sigsafe.out", want, sizeof(want) - 1);
+	check_true("%D return", n == (int)sizeof(want) - 1);
+}
+
+/**
+ * on_signal - Print from inside a signal handler.
+ * @sig: The signal.
+ */
+static void on_signal(int sig)
+{
+	handler_ret = _printf_sigsafe("caught %d, %s %#x\n", sig, "in handler",
+			255u);
+}
+
+/**
+ * money - A registered conversion the signal-safe path must refuse.
+ * @types: The arguments.
+ * @out: The writer.
+ * @spec: The directive.
+ *
+ * Return: 1.
+ */
+static int money(va_list types, writer_t *out, const spec_t *spec)
+{
+	(void)types;
+	(void)spec;
+
+	return (writer_write(out, "$", 1));
+}
+
+/**
+ * main - Run the checks.
+ *
+ * Return: 0 if all passed, 1 otherwise.
+ */
+int main(void)
+{
+	static const char want[] = "caught 10, in handler 0xff\n";
+	char buf[64];
+	int fd = open("test_sigsafe.stdout", O_RDWR | O_CREAT | O_TRUNC, 0644);
+	int saved = dup(1);
+
+	sig_glibc("%d|%ld|%u|%5.3d|%-+6d|%x|%#o|%X", -42, -1L, 7u, 9, 3,
+			0xbeefu, 8u, 255u);
+	sig_glibc("[%s][%10s][%.3s][%c][%p][%%]", "a fairly long string",
+			"pad", "truncated", 'z', (void *)0x1234);
+	check_fixed();
+
+	dup2(fd, 1);
+	signal(SIGUSR1, on_signal);
+	raise(SIGUSR1);
+	dup2(saved, 1);
+	close(saved);
+	close(fd);
+	check_file("_printf_sigsafe in a handler", "test_sigsafe.stdout",
+			want, sizeof(want) - 1);
+	check_true("handler return", handler_ret == (int)sizeof(want) - 1);
+
+	errno = EDOM;
+	check_true("%T refused", _dprintf_sigsafe(2, buf, sizeof(buf),
+				"%T") == -1);
+	_printf_register('m', money);
+	check_true("registered refused", _dprintf_sigsafe(2, buf,
+				sizeof(buf), "%m") == -1);
+	_printf_register('m', NULL);
+	check_true("errno preserved", errno == EDOM);
+
+	return (check_done("test_sigsafe"));
+}
@@ -0,0 +1,110 @@
+#include "check.h"
+#include <fcntl.h>
+#include <stdio.h>
+
+/*
+ * test_stack - Stack used by one call of _printf, _printf_sigsafe and
+ * _asprintf against the bounds documented next to BUFF_SIZE. Each call
+ * runs on a thread whose stack is pre-filled with a pattern, and the
+ * depth reached by a thread that makes no call is taken off.
+ */
+
+#define STACK_SIZE (64 * 1024)
+#define STACK_FILL 0xA5
+/* Room for the frame of one_call and for differences between compilers */
+#define STACK_SLACK 512
+
+static char stack[STACK_SIZE] __attribute__((aligned(4096)));
+
+/**
+ * one_call - Make the call selected by @arg.
+ * @arg: Points to 0 for _printf, 1 for _printf_sigsafe, 2 for _asprintf,
+ * or 3 for no call at all.
+ *
+ * Return: NULL.
+ */
+static void *one_call(void *arg)
+{
+	static char mem[256];
+	arena_t arena;
+	char *s;
+
+	if (*(int *)arg == 0)
+		_printf("%s %-20d %#x %.3T %J\n", "message", 42, 255u, "q\"");
+	else if (*(int *)arg == 1)
+		_printf_sigsafe("%s %-20d %#x\n", "message", 42, 255u);
+	else if (*(int *)arg == 2)
+	{
+		arena_init(&arena, mem, sizeof(mem));
+		_asprintf(&arena, &s, "%s %-20d %#x", "message", 42, 255u);
+	}
+
+	return (NULL);
+}
+
+/**
+ * measure - Run one call on a pre-filled thread stack.
+ * @which: The call, as for one_call.
+ *
+ * Return: The depth of stack the thread wrote to.
+ */
+static long measure(int which)
+{
+	pthread_attr_t attr;
+	pthread_t thread;
+	long i;
+
+	memset(stack, STACK_FILL, sizeof(stack));
+	pthread_attr_init(&attr);
+	pthread_attr_setstack(&attr, stack, sizeof(stack));
+	pthread_create(&thread, &attr, one_call, &which);
+	pthread_join(thread, NULL);
+	pthread_attr_destroy(&attr);
+	for (i = 0; i < STACK_SIZE && (unsigned char)stack[i] == STACK_FILL;
+			i++)
+		;
+
+	return (STACK_SIZE - i);
+}
+
+/**
+ * check_bound - Check the stack used by one call against its bound.
+ * @name: The function called.
+ * @used: The stack it used.
+ * @bound: The documented bound.
+ */
+static void check_bound(const char *name, long used, long bound)
+{
+	char what[96];
+
+	sprintf(what, "%s uses %ld bytes, bound %ld", name, used, bound);
+	check_true(what, used <= bound + STACK_SLACK);
+}
+
+/**
+ * main - Run the checks.
+ *
+ * Return: 0 if all passed, 1 otherwise.
+ */
+int main(void)
+{
+	int fd = open("/dev/null", O_WRONLY), saved = dup(1), i;
+	long used[4];
+
+	dup2(fd, 1);
+	for (i = 0; i < 4; i++)
+		measure(i);
+	for (i = 0; i < 4; i++)
+		used[i] = measure(i);
+	fd_sink_drain(fd_sink_stdout());
+	dup2(saved, 1);
+	close(saved);
+	close(fd);
+
+	check_bound("_printf", used[0] - used[3], 3 * BUFF_SIZE + 2048);
+	check_bound("_printf_sigsafe", used[1] - used[3],
+			2 * BUFF_SIZE + 1024);
+	check_bound("_asprintf", used[2] - used[3], BUFF_SIZE + 1024);
+
+	return (check_done("test_stack"));
+}
@@ -0,0 +1,96 @@
+#include "check.h"
+#include <stdio.h>
+
+/*
+ * test_tee - Output formatted once and copied to several sinks, one of
+ * which fails.
+ */
+
+static int conversions;
+
+/**
+ * counted - A conversion that counts how often it is formatted.
+ * @types: The arguments.
+ * @out: The writer.
+ * @spec: The directive.
+ *
+ * Return: 1.
+ */
+static int counted(va_list types, writer_t *out, const spec_t *spec)
+{
+	(void)types;
+	(void)spec;
+	conversions++;
+
+	return (writer_write(out, "k", 1));
+}
+
+/**
+ * collect - Callback sink function appending to a mem sink.
+ * @arg: The mem_sink_t.
+ * @s: The chunk.
+ * @n: Its length.
+ *
+ * Return: 0, or -1 if the mem sink is full.
+ */
+static int collect(void *arg, const char *s, int n)
+{
+	mem_sink_t *sink = arg;
+
+	return (writer_write(&sink->out, s, n) == n ? 0 : -1);
+}
+
+/**
+ * main - Run the checks.
+ *
+ * Return: 0 if all passed, 1 otherwise.
+ */
+int main(void)
+{
+	static char a[CHECK_BUF], b[CHECK_BUF], c[CHECK_BUF], want[CHECK_BUF];
+	static mem_sink_t ma, mb, mc, tiny;
+	static callback_sink_t cb;
+	static tee_sink_t tee;
+	char small[16];
+	int i, len, status;
+
+	mem_sink_open(&ma, a, sizeof(a));
+	mem_sink_open(&mb, b, sizeof(b));
+	mem_sink_open(&mc, c, sizeof(c));
+	callback_sink_open(&cb, collect, &mc);
+	tee_sink_open(&tee);
+	tee_sink_add(&tee, &ma.out, 0);
+	tee_sink_add(&tee, &mb.out, 0);
+	tee_sink_add(&tee, &cb.out, 1);
+
+	_printf_register('k', counted);
+	_wprintf(&tee.out, "[%k] %s=%d|%-8x|\n", "answer", 42, 0xbeefu);
+	status = tee_sink_commit(&tee);
+	len = snprintf(want, sizeof(want), "[k] %s=%d|%-8x|\n", "answer", 42,
+			0xbeefu);
+	check_true("formatted once", conversions == 1 && status == 0);
+	check_bytes("synced destination", c, mc.out.len, want, len);
+	check_true("others buffered", ma.out.len == len && mb.out.len == len);
+
+	_wprintf(&tee.out, "%*d\n", 3 * BUFF_SIZE, 7);
+	len += snprintf(want + len, sizeof(want) - len, "%*d\n",
+			3 * BUFF_SIZE, 7);
+	mem_sink_open(&tiny, small, sizeof(small));
+	check_true("add tiny", tee_sink_add(&tee, &tiny.out, 1) == 0);
+	_wprintf(&tee.out, "after %s\n", "failure");
+	check_true("failure reported", tee_sink_commit(&tee) == -1 &&
+			tiny.out.error);
+	len += snprintf(want + len, sizeof(want) - len, "after %s\n",
+			"failure");
+	check_bytes("first copy", a, ma.out.len, want, len);
+	check_bytes("second copy", b, mb.out.len, want, len);
+	check_bytes("third copy", c, mc.out.len, want, len);
+
+	for (i = tee.count; i < TEE_SINKS; i++)
+		tee_sink_add(&tee, &ma.out, 0);
+	check_true("too many destinations", tee_sink_add(&tee, &mb.out, 0) ==
+			-1 && tee.count == TEE_SINKS);
+	_printf_register('k', NULL);
+
+	return (check_done("test_tee"));
+}
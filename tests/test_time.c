@@ -0,0 +1,78 @@
+#define _GNU_SOURCE
+#include "check.h"
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * test_time - The %T timestamp against strftime, with fractional digits
+ * and padding, in a zone whose offset is not a whole hour.
+ */
+
+/**
+ * same_second - Format @format and the local time by strftime within one
+ * second, retrying if the clock ticks over in between.
+ * @format: The format, starting with %T or a padded %T.
+ * @got: Receives the output of _wprintf.
+ * @want: Receives "YYYY-MM-DD HH:MM:SS" from strftime.
+ *
+ * Return: The length of @got.
+ */
+static int same_second(const char *format, char *got, char *want)
+{
+	mem_sink_t sink;
+	struct tm tm;
+	struct timespec before, after;
+	int tries;
+
+	for (tries = 0; tries < 5; tries++)
+	{
+		clock_gettime(CLOCK_REALTIME, &before);
+		mem_sink_open(&sink, got, 64);
+		_wprintf(&sink.out, format);
+		clock_gettime(CLOCK_REALTIME, &after);
+		if (before.tv_sec == after.tv_sec)
+			break;
+	}
+	localtime_r(&before.tv_sec, &tm);
+	strftime(want, 32, "%Y-%m-%d %H:%M:%S", &tm);
+
+	return (sink.out.len);
+}
+
+/**
+ * main - Run the checks.
+ *
+ * Return: 0 if all passed, 1 otherwise.
+ */
+int main(void)
+{
+	char got[64], want[32];
+	int n, i, digits;
+
+	setenv("TZ", "Asia/Kathmandu", 1);
+	tzset();
+
+	n = same_second("%T", got, want);
+	check_bytes("%T", got, n, want, 19);
+
+	n = same_second("%.3T", got, want);
+	check_bytes("%.3T date", got, 19, want, 19);
+	for (i = 20, digits = 0; i < n; i++)
+		digits += got[i] >= '0' && got[i] <= '9';
+	check_true("%.3T fraction", n == 23 && got[19] == '.' && digits == 3);
+
+	n = same_second("%.9T", got, want);
+	check_true("%.9T length", n == 29 && got[19] == '.');
+
+	n = same_second("%-24T|", got, want);
+	check_bytes("%-24T", got, 19, want, 19);
+	check_true("%-24T pads right", n == 25 &&
+			memcmp(got + 19, "     |", 6) == 0);
+
+	n = same_second("%24T", got, want);
+	check_true("%24T pads left", n == 24 &&
+			memcmp(got, "     ", 5) == 0 &&
+			memcmp(got + 5, want, 19) == 0);
+
+	return (check_done("test_time"));
+}
@@ -0,0 +1,64 @@
+#include "check.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * test_uring - Output through a uring_sink_t to a file at its offset and
+ * to a file opened for appending, which is written as a stream. Where
+ * io_uring is not available this checks the write(2) fallback instead.
+ */
+
+#define URING_LINES 100000
+#define URING_FORMAT "%ld: %s %#lx %-9d|\n"
+#define URING_ARGS(i) (i), "queued write", (unsigned long)(i) << 20, \
+	(int)(i) * -3
+
+/**
+ * run - Write the test lines through a uring sink and check the file.
+ * @path: The file.
+ * @flags: Extra open flags.
+ * @want: The expected lines.
+ * @len: Their length.
+ */
+static void run(const char *path, int flags, const char *want, long len)
+{
+	static uring_sink_t sink;
+	int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | flags, 0644);
+	long i;
+
+	if (!check_true(path, fd != -1 && write(fd, "head\n", 5) == 5 &&
+				uring_sink_open(&sink, fd) == 0))
+		return;
+	for (i = 0; i < URING_LINES; i++)
+		_wprintf(&sink.out, URING_FORMAT, URING_ARGS(i));
+	check_true("uring_sink_close", uring_sink_close(&sink) == 0);
+	check_true("position after close", lseek(fd, 0, SEEK_CUR) == len);
+	close(fd);
+	check_file(path, path, want, len);
+}
+
+/**
+ * main - Run the checks.
+ *
+ * Return: 0 if all passed, 1 otherwise.
+ */
+int main(void)
+{
+	long cap = URING_LINES * 64L, len = 5, i;
+	char *want = malloc(cap);
+
+	if (want == NULL)
+		return (1);
+	memcpy(want, "head\n", 5);
+	for (i = 0; i < URING_LINES; i++)
+		len += snprintf(want + len, cap - len, URING_FORMAT,
+				URING_ARGS(i));
+	check_true("more than all buffers",
+			len > URING_SINK_BUFS * URING_SINK_BUF_SIZE);
+	run("test_uring.log", 0, want, len);
+	run("test_uring_append.log", O_APPEND, want, len);
+	free(want);
+
+	return (check_done("test_uring"));
+}
@@ -0,0 +1,54 @@
+#include "check.h"
+#include <locale.h>
+#include <wchar.h>
+
+/*
+ * test_wide - %ls and %lc against the C library in a UTF-8 locale, and
+ * widths counted in code points or columns.
+ */
+
+/**
+ * main - Run the checks.
+ *
+ * Return: 0 if all passed, 1 otherwise.
+ */
+int main(void)
+{
+	static const wchar_t mixed[] = L"plain ascii run, caf\x00e9 "
+		L"\x20ac\x4e2d\x6587 \x1f600 and ascii again";
+	static const wchar_t cjk[] = L"\x4e2d\x6587";
+
+	if (setlocale(LC_ALL, "C.UTF-8") == NULL)
+	{
+		check_true("C.UTF-8 locale", 0);
+		return (check_done("test_wide"));
+	}
+	check_glibc("[%ls]", mixed);
+	check_glibc("[%ls][%ls]", L"", L"abcdefghijklmnopqrstuvwxyz0123");
+	check_glibc("[%40ls][%-40ls]", mixed + 16, mixed + 16);
+	check_glibc("[%.22ls][%.23ls][%.24ls]", mixed, mixed, mixed);
+	check_glibc("[%8.4ls][%-8.5ls]", cjk, cjk);
+	check_glibc("[%lc][%lc][%lc][%lc]", (wint_t)'a', (wint_t)0xe9,
+			(wint_t)0x20ac, (wint_t)0x1f600);
+	check_glibc("[%5lc][%-5lc]", (wint_t)0x20ac, (wint_t)0x1f600);
+
+	check_fmt("[(null)][  (null)]", "[%ls][%8ls]", (wchar_t *)NULL,
+			(wchar_t *)NULL);
+
+	check_true("bad mode", _printf_set_width_mode(3) == -1);
+	_printf_set_width_mode(WIDTH_CODEPOINTS);
+	check_fmt("[   \xe4\xb8\xad\xe6\x96\x87][\xe4\xb8\xad]",
+			"[%5ls][%.1ls]", cjk, cjk);
+	check_fmt("[caf\xc3\xa9  |]", "[%-6s|]", "caf\xc3\xa9");
+	check_fmt("[  \xe2\x82\xac]", "[%3lc]", (wint_t)0x20ac);
+	_printf_set_width_mode(WIDTH_COLUMNS);
+	check_fmt("[ \xe4\xb8\xad\xe6\x96\x87][\xe4\xb8\xad]", "[%5ls][%.3ls]",
+			cjk, cjk);
+	check_fmt("[\xe4\xb8\xad\xe6\x96\x87  |]", "[%-6s|]",
+			"\xe4\xb8\xad\xe6\x96\x87");
+	_printf_set_width_mode(WIDTH_BYTES);
+	check_fmt("[\xe4\xb8\xad\xe6\x96\x87][\xe4\xb8\xad]", "[%5ls][%.5ls]",
+			cjk, cjk);
+
+	return (check_done("test_wide"));
+}
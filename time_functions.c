@@ -0,0 +1,139 @@
+#include "main.h"
+#include <time.h>
+
+/*
+ * UTC offsets, and the instants they change at, are whole quarter hours
+ * in every zone in use (+05:45, +10:30 and +12:45 included).
+ */
+#define TIME_TZ_SLOT 900
+
+/**
+ * struct time_cache - Per-thread state of the timestamp conversion.
+ * @ready: Non-zero once @prefix holds a rendered second.
+ * @sec: The second @prefix was rendered for.
+ * @tz_slot: The quarter hour (sec / TIME_TZ_SLOT) @tz_off was looked up in.
+ * @tz_off: Offset of local time from UTC, in seconds.
+ * @prefix: "YYYY-MM-DD HH:MM:SS" for @sec, in local time.
+ */
+struct time_cache
+{
+	int ready;
+	long sec;
+	long tz_slot;
+	long tz_off;
+	char prefix[TIME_PREFIX_LEN];
+};
+
+static __thread struct time_cache time_cache;
+
+/**
+ * time_digits - Write a number as a fixed count of decimal digits.
+ *
+ * @dst: Where the digits go.
+ * @n: The number of digits.
+ * @value: The value, written with leading zeros.
+ */
+static void time_digits(char *dst, int n, unsigned long value)
+{
+	while (n-- > 0)
+	{
+		dst[n] = '0' + value % 10;
+		value /= 10;
+	}
+}
+
+/**
+ * time_render - Render the cached date and time for a new second.
+ *
+ * The calendar date is computed from the day count directly, so
+ * localtime_r is only called to refresh the UTC offset, at most once a
+ * quarter hour per thread. Offset changes do not all happen on the hour:
+ * Adelaide and Lord Howe switch at :30 UTC, so a refresh once an hour
+ * would print the old local time for up to half an hour after a switch.
+ *
+ * @c: The calling thread's cache.
+ * @sec: Seconds since the epoch.
+ */
+static void time_render(struct time_cache *c, long sec)
+{
+	struct tm tm;
+	time_t now = sec;
+	long local, days, doe, yoe, doy, mp, year, month;
+
+	if (!c->ready || sec / TIME_TZ_SLOT != c->tz_slot)
+	{
+		localtime_r(&now, &tm);
+		c->tz_off = tm.tm_gmtoff;
+		c->tz_slot = sec / TIME_TZ_SLOT;
+	}
+	local = sec + c->tz_off;
+	days = local / 86400 + 719468;
+	doe = days % 146097;
+	yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	mp = (5 * doy + 2) / 153;
+	month = mp < 10 ? mp + 3 : mp - 9;
+	year = yoe + days / 146097 * 400 + (month <= 2);
+
+	memcpy(c->prefix, "0000-00-00 00:00:00", TIME_PREFIX_LEN);
+	time_digits(c->prefix, 4, year);
+	time_digits(c->prefix + 5, 2, month);
+	time_digits(c->prefix + 8, 2, doy - (153 * mp + 2) / 5 + 1);
+	time_digits(c->prefix + 11, 2, local % 86400 / 3600);
+	time_digits(c->prefix + 14, 2, local % 3600 / 60);
+	time_digits(c->prefix + 17, 2, local % 60);
+	c->sec = sec;
+	c->ready = 1;
+}
+
+/**
+ * print_time - Print the current local time.
+ *
+ * This function handles %T, which takes no argument. It prints
+ * "YYYY-MM-DD HH:MM:SS" followed, when a precision is given, by that many
+ * fractional digits: %.3T for milliseconds, %.6T for microseconds and
+ * %.9T for nanoseconds. The clock is read with clock_gettime (a vDSO
+ * call on Linux) and the date and time part is rendered once per second
+ * per thread; other calls only render the fractional digits.
+ *
+ * @types: Unused, %T consumes no argument.
+ * @out: The writer receiving the output.
+ * @spec: The parsed directive; precision is the number of fractional
+ * digits, '-' left-justifies within the width.
+ *
+ * Return: The number of characters printed.
+ */
+int print_time(va_list types, writer_t *out, const spec_t *spec)
+{
+	static const unsigned long scale[] = {1, 10, 100, 1000, 10000, 100000,
+		1000000, 10000000, 100000000, 1000000000};
+	struct timespec ts;
+	struct time_cache *c = &time_cache;
+	char *buffer = out->scratch;
+	int len = TIME_PREFIX_LEN, precision = spec->precision;
+	int width = spec->width;
+
+	UNUSED(types);
+	clock_gettime(CLOCK_REALTIME, &ts);
+	if (!c->ready || ts.tv_sec != c->sec)
+		time_render(c, ts.tv_sec);
+
+	memcpy(buffer, c->prefix, TIME_PREFIX_LEN);
+	if (precision > 9)
+		precision = 9;
+	if (precision > 0)
+	{
+		buffer[len] = '.';
+		time_digits(buffer + len + 1, precision,
+				ts.tv_nsec / scale[9 - precision]);
+		len += precision + 1;
+	}
+
+	if (!(spec->flags & F_MINUS))
+		writer_pad(out, ' ', width - len);
+	writer_write(out, buffer, len);
+	if (spec->flags & F_MINUS)
+		writer_pad(out, ' ', width - len);
+
+	return (width > len ? width : len);
+}
@@ -0,0 +1,134 @@
+#include "main.h"
+#include <stdlib.h>
+
+/*
+ * lz_cat - Decompress the output of an lz_sink_t.
+ *
+ * Reads a compressed stream on standard input and writes the original
+ * text to standard output. Build it next to the library sources:
+ *
+ *	gcc -Wall -Wextra -pedantic -std=gnu89 -I. tools/lz_cat.c \
+ *		lz_functions.c -o lz_cat
+ */
+
+/**
+ * read_full - Read exactly @n bytes.
+ *
+ * @fd: The descriptor.
+ * @buf: Where the bytes go.
+ * @n: How many to read.
+ *
+ * Return: 1 if all were read, 0 on end of file or error.
+ */
+static int read_full(int fd, char *buf, long n)
+{
+	long done = 0, got;
+
+	while (done < n)
+	{
+		got = read(fd, buf + done, n - done);
+		if (got <= 0)
+			return (0);
+		done += got;
+	}
+
+	return (1);
+}
+
+/**
+ * write_full - Write exactly @n bytes.
+ *
+ * @fd: The descriptor.
+ * @buf: The bytes.
+ * @n: How many to write.
+ *
+ * Return: 1 on success, 0 on error.
+ */
+static int write_full(int fd, const char *buf, long n)
+{
+	long done = 0, put;
+
+	while (done < n)
+	{
+		put = write(fd, buf + done, n - done);
+		if (put <= 0)
+			return (0);
+		done += put;
+	}
+
+	return (1);
+}
+
+/**
+ * get32 - Decode a 4-byte little-endian number.
+ *
+ * @p: The bytes.
+ *
+ * Return: The number.
+ */
+static unsigned long get32(const char *p)
+{
+	const unsigned char *u = (const unsigned char *)p;
+
+	return (u[0] | u[1] << 8 | (unsigned long)u[2] << 16 |
+			(unsigned long)u[3] << 24);
+}
+
+/**
+ * cat_frame - Decompress one frame to standard output.
+ *
+ * @hdr: The frame header.
+ * @in: Buffer for the stored bytes, grown as needed.
+ * @out: Buffer for the original bytes, grown as needed.
+ *
+ * Return: 1 for a data frame, 0 for the end frame, -1 on error.
+ */
+static int cat_frame(const char *hdr, char **in, char **out)
+{
+	unsigned long raw = get32(hdr), stored = get32(hdr + 4);
+	int is_raw = (stored & 0x80000000UL) != 0;
+
+	stored &= 0x7FFFFFFFUL;
+	if (raw == 0)
+		return (0);
+	if (raw > 0x7FFFFFFFUL || stored > LZ_BOUND(raw))
+		return (-1);
+	*in = realloc(*in, stored + 1);
+	*out = realloc(*out, raw);
+	if (*in == NULL || *out == NULL || !read_full(0, *in, stored))
+		return (-1);
+	if (is_raw)
+		return (stored == raw && write_full(1, *in, raw) ? 1 : -1);
+	if (lz_decompress(*in, stored, *out, raw) != (int)raw)
+		return (-1);
+
+	return (write_full(1, *out, raw) ? 1 : -1);
+}
+
+/**
+ * main - Decompress standard input to standard output.
+ *
+ * Return: 0 on success, 1 if the stream is malformed or truncated.
+ */
+int main(void)
+{
+	char magic[LZ_MAGIC_LEN], hdr[LZ_FRAME_HDR], *in = NULL, *out = NULL;
+	int status;
+
+	if (!read_full(0, magic, LZ_MAGIC_LEN) ||
+			memcmp(magic, LZ_MAGIC, LZ_MAGIC_LEN) != 0)
+	{
+		write(2, "lz_cat: not a compressed stream\n", 32);
+		return (1);
+	}
+	do {
+		status = read_full(0, hdr, LZ_FRAME_HDR) ?
+			cat_frame(hdr, &in, &out) : -1;
+	} while (status == 1);
+	free(in);
+	free(out);
+	if (status == -1)
+		write(2, "lz_cat: corrupt or truncated stream\n", 36);
+
+	return (status == -1);
+}
@@ -0,0 +1,279 @@
+#include "main.h"
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * pf_replay - Play a trace recorded with _printf_capture back through the
+ * library at full speed, to measure changes against real traffic.
+ *
+ *	pf_replay [-s printf|asprintf|mem] [-n rounds] < trace > output
+ *
+ * printf replays through _printf, asprintf through _asprintf into an
+ * arena, and mem through _wprintf into a mem_sink_t, which measures the
+ * formatting alone. The calls, characters and time taken are reported on
+ * standard error. Build it next to the library sources:
+ *
+ *	gcc -Wall -Wextra -pedantic -std=gnu89 -I. tools/pf_replay.c \
+ *		$(ls *.c | grep -v '^main.c$') -o pf_replay -pthread
+ *
+ * Each call is replayed with REPLAY_ARGS unsigned long arguments: the
+ * numbers as recorded and pointers to copies of the strings and arrays.
+ * That is how the library's integer and pointer arguments are passed on
+ * the usual 64-bit ABIs, where every variadic argument takes a full slot.
+ * Calls with more arguments than that are skipped, and so are calls
+ * that reached a conversion registered with _printf_register, which the
+ * trace does not hold the arguments of; both are counted and reported
+ * with the timings.
+ * The trace is decoded with bounds checks, but its formats are trusted:
+ * like a bad _printf call, a corrupted one can make a conversion read a
+ * number as a pointer.
+ */
+
+#define REPLAY_ARGS 16
+#define REPLAY_MEM (1024 * 1024)
+
+/**
+ * struct call - One recorded _printf call.
+ * @format: The format string.
+ * @args: The arguments; pointers are stored as numbers.
+ */
+struct call
+{
+	const char *format;
+	unsigned long args[REPLAY_ARGS];
+};
+
+/**
+ * read_all - Read a whole file descriptor into memory.
+ *
+ * @fd: The descriptor.
+ * @len: Receives the number of bytes read.
+ *
+ * Return: The bytes, or NULL on error.
+ */
+static unsigned char *read_all(int fd, long *len)
+{
+	unsigned char *buf = NULL, *grown;
+	long cap = 0, got;
+
+	*len = 0;
+	do {
+		if (*len == cap)
+		{
+			cap = cap ? cap * 2 : 1 << 20;
+			grown = realloc(buf, cap);
+			if (grown == NULL)
+				break;
+			buf = grown;
+		}
+		got = read(fd, buf + *len, cap - *len);
+		*len += got > 0 ? got : 0;
+	} while (got > 0);
+	if (got != 0)
+	{
+		free(buf);
+		return (NULL);
+	}
+
+	return (buf);
+}
+
+/**
+ * get_field - Read a LEB128 number and, optionally, that many bytes.
+ *
+ * @p: The trace.
+ * @n: Its length.
+ * @i: Where the field starts; left just past it.
+ * @v: Receives the number.
+ * @copy: If not NULL, receives a NUL-terminated copy of the @v bytes
+ * that follow, aligned for any element type.
+ *
+ * Return: 0 on success, -1 if the trace is truncated or out of memory.
+ */
+static int get_field(const unsigned char *p, long n, long *i,
+		unsigned long *v, char **copy)
+{
+	int shift = 0;
+
+	*v = 0;
+	do {
+		if (*i >= n || shift > 63)
+			return (-1);
+		*v |= (unsigned long)(p[*i] & 0x7F) << shift;
+		shift += 7;
+	} while (p[(*i)++] & 0x80);
+	if (copy == NULL)
+		return (0);
+	if (*v > (unsigned long)(n - *i))
+		return (-1);
+
+	*copy = calloc(1, *v + sizeof(wchar_t));
+	if (*copy == NULL)
+		return (-1);
+	memcpy(*copy, p + *i, *v);
+	*i += *v;
+
+	return (0);
+}
+
+/**
+ * decode_trace - Turn a trace into an array of calls.
+ *
+ * @p: The trace, after its magic.
+ * @n: Its length.
+ * @calls: Receives the calls; grown as needed.
+ * @count: Receives the number of calls.
+ * @skipped: Receives the number of calls left out for having more than
+ * REPLAY_ARGS arguments, then the number left out for reaching a
+ * registered conversion.
+ *
+ * Return: 0 on success, -1 if the trace is malformed.
+ */
+static int decode_trace(const unsigned char *p, long n, struct call **calls,
+		long *count, long skipped[2])
+{
+	static char *formats[CAPTURE_FORMATS];
+	long i = 0, cap = 0;
+	unsigned long id, v;
+	char *s, tag;
+	struct call *c;
+	int a, custom;
+
+	for (*count = 0, skipped[0] = skipped[1] = 0; i < n; )
+	{
+		tag = p[i++];
+		if (get_field(p, n, &i, &id, NULL) == -1 ||
+				id >= CAPTURE_FORMATS)
+			return (-1);
+		if (tag == CAP_FORMAT)
+		{
+			if (get_field(p, n, &i, &v, &formats[id]) == -1)
+				return (-1);
+			continue;
+		}
+		if (tag != CAP_CALL || formats[id] == NULL)
+			return (-1);
+		if (*count == cap)
+		{
+			cap = cap ? cap * 2 : 4096;
+			*calls = realloc(*calls, cap * sizeof(**calls));
+			if (*calls == NULL)
+				return (-1);
+		}
+		c = memset(&(*calls)[(*count)++], 0, sizeof(*c));
+		c->format = formats[id];
+		for (a = 0, custom = 0; i < n && p[i] != CAP_END; a++)
+		{
+			tag = p[i++], s = NULL, v = 0;
+			custom |= tag == CAP_CUSTOM;
+			if (tag != CAP_NULL && tag != CAP_CUSTOM &&
+					get_field(p, n, &i, &v,
+					tag == CAP_WORD ? NULL : &s) == -1)
+				return (-1);
+			v = (v >> 1) ^ (0 - (v & 1));
+			if (a < REPLAY_ARGS)
+				c->args[a] = s ? (unsigned long)s : v;
+		}
+		if (i++ >= n)
+			return (-1);
+		if (custom)
+			(*count)--, skipped[1]++;
+		else if (a > REPLAY_ARGS)
+			(*count)--, skipped[0]++;
+	}
+
+	return (0);
+}
+
+/**
+ * replay_call - Replay one call through the chosen entry point.
+ *
+ * @sink: 'p' for _printf, 'a' for _asprintf, 'm' for a memory sink.
+ * @c: The call.
+ * @arena: The arena for 'a'.
+ * @mem: The memory sink for 'm'.
+ *
+ * Return: What the entry point returned.
+ */
+static int replay_call(char sink, const struct call *c, arena_t *arena,
+		mem_sink_t *mem)
+{
+	const unsigned long *a = c->args;
+	char *s;
+
+	if (sink == 'p')
+		return (_printf(c->format, a[0], a[1], a[2], a[3], a[4],
+				a[5], a[6], a[7], a[8], a[9], a[10], a[11],
+				a[12], a[13], a[14], a[15]));
+	if (sink == 'a')
+	{
+		arena_reset(arena);
+		return (_asprintf(arena, &s, c->format, a[0], a[1], a[2],
+				a[3], a[4], a[5], a[6], a[7], a[8], a[9],
+				a[10], a[11], a[12], a[13], a[14], a[15]));
+	}
+	mem->out.len = 0;
+	mem->out.error = 0;
+
+	return (_wprintf(&mem->out, c->format, a[0], a[1], a[2], a[3],
+			a[4], a[5], a[6], a[7], a[8], a[9], a[10], a[11],
+			a[12], a[13], a[14], a[15]));
+}
+
+/**
+ * main - Replay a trace from standard input.
+ *
+ * @argc: The number of arguments.
+ * @argv: -s printf|asprintf|mem and -n rounds.
+ *
+ * Return: 0 on success, 1 on a bad command line or trace.
+ */
+int main(int argc, char **argv)
+{
+	static char mem[REPLAY_MEM], report[BUFF_SIZE];
+	char sink = 'p';
+	long len, count, skipped[2], i, r, rounds = 1, printed = 0;
+	unsigned char *trace = read_all(0, &len);
+	struct call *calls = NULL;
+	struct timespec t0, t1;
+	arena_t arena;
+	mem_sink_t out;
+
+	for (i = 1; i + 1 < argc; i += 2)
+		if (strcmp(argv[i], "-s") == 0)
+			sink = argv[i + 1][0];
+		else if (strcmp(argv[i], "-n") == 0)
+			rounds = atol(argv[i + 1]);
+	if (trace == NULL || len < CAPTURE_MAGIC_LEN ||
+			memcmp(trace, CAPTURE_MAGIC, CAPTURE_MAGIC_LEN) != 0 ||
+			decode_trace(trace + CAPTURE_MAGIC_LEN,
+				len - CAPTURE_MAGIC_LEN, &calls, &count,
+				skipped) == -1)
+	{
+		write(2, "pf_replay: not a valid trace\n", 29);
+		return (1);
+	}
+	arena_init(&arena, mem, REPLAY_MEM);
+	mem_sink_open(&out, mem, REPLAY_MEM);
+
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	for (r = 0; r < rounds; r++)
+		for (i = 0; i < count; i++)
+			printed += replay_call(sink, &calls[i], &arena, &out);
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	len = (t1.tv_sec - t0.tv_sec) * 1000000000L + t1.tv_nsec - t0.tv_nsec;
+	count *= rounds;
+	_dprintf_sigsafe(2, report, BUFF_SIZE,
+			"%ld calls, %ld chars, %ld ns, %ld ns/call\n",
+			count, printed, len, count > 0 ? len / count : 0L);
+	if (skipped[0] > 0)
+		_dprintf_sigsafe(2, report, BUFF_SIZE,
+				"%ld calls with over %d arguments skipped\n",
+				skipped[0], REPLAY_ARGS);
+	if (skipped[1] > 0)
+		_dprintf_sigsafe(2, report, BUFF_SIZE,
+				"%ld calls with registered conversions"
+				" skipped\n", skipped[1]);
+
+	return (0);
+}
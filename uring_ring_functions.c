@@ -0,0 +1,233 @@
+#include "main.h"
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+
+#if defined(__NR_io_uring_setup) && defined(IORING_FEAT_RW_CUR_POS)
+/**
+ * uring_ring_setup - Create an io_uring and register the sink's buffers.
+ *
+ * The submission ring, completion ring and SQE array are mapped into the
+ * process. The buffers are registered so writes can use WRITE_FIXED; if the
+ * kernel refuses (for example because of RLIMIT_MEMLOCK) plain WRITE is
+ * used instead.
+ *
+ * @r: The ring state to fill in.
+ * @entries: The number of submission entries.
+ * @bufs: The buffer pool, @nbufs buffers of @bufsize bytes.
+ * @nbufs: The number of buffers.
+ * @bufsize: The size of each buffer.
+ *
+ * Return: 0 on success, -1 if io_uring is unavailable.
+ */
+int uring_ring_setup(uring_t *r, unsigned int entries,
+		char *bufs, int nbufs, int bufsize)
+{
+	struct io_uring_params p;
+	struct iovec iov[URING_SINK_BUFS];
+	int i;
+
+	memset(&p, 0, sizeof(p));
+	memset(r, 0, sizeof(*r));
+	r->ring_fd = syscall(__NR_io_uring_setup, entries, &p);
+	if (r->ring_fd < 0)
+		return (-1);
+	r->sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned int);
+	r->cq_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+	r->sqe_size = p.sq_entries * sizeof(struct io_uring_sqe);
+	if ((p.features & IORING_FEAT_SINGLE_MMAP) && r->cq_size > r->sq_size)
+		r->sq_size = r->cq_size;
+	r->sq_map = mmap(NULL, r->sq_size, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_POPULATE, r->ring_fd, IORING_OFF_SQ_RING);
+	r->cq_map = (p.features & IORING_FEAT_SINGLE_MMAP) ? r->sq_map :
+		mmap(NULL, r->cq_size, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_POPULATE, r->ring_fd, IORING_OFF_CQ_RING);
+	r->sqes = mmap(NULL, r->sqe_size, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_POPULATE, r->ring_fd, IORING_OFF_SQES);
+	if (r->sq_map == MAP_FAILED || r->cq_map == MAP_FAILED ||
+			r->sqes == MAP_FAILED)
+	{
+		uring_ring_free(r);
+		return (-1);
+	}
+	r->sq_tail = (unsigned int *)((char *)r->sq_map + p.sq_off.tail);
+	r->sq_mask = (unsigned int *)((char *)r->sq_map + p.sq_off.ring_mask);
+	r->sq_array = (unsigned int *)((char *)r->sq_map + p.sq_off.array);
+	r->cq_head = (unsigned int *)((char *)r->cq_map + p.cq_off.head);
+	r->cq_tail = (unsigned int *)((char *)r->cq_map + p.cq_off.tail);
+	r->cq_mask = (unsigned int *)((char *)r->cq_map + p.cq_off.ring_mask);
+	r->cqes = (char *)r->cq_map + p.cq_off.cqes;
+	for (i = 0; i < nbufs; i++)
+		iov[i].iov_base = bufs + i * bufsize, iov[i].iov_len = bufsize;
+	r->fixed = syscall(__NR_io_uring_register, r->ring_fd,
+			IORING_REGISTER_BUFFERS, iov, nbufs) == 0;
+
+	return (0);
+}
+
+/**
+ * uring_ring_queue - Prepare a write of one pool buffer.
+ *
+ * The entry is only published to the kernel; it is not submitted until
+ * uring_ring_submit. Writes to files use explicit offsets, so their
+ * completion order does not matter; writes to streams (@off == -1) use the
+ * descriptor's position and are also marked IOSQE_IO_DRAIN.
+ *
+ * @r: The ring.
+ * @fd: The destination file descriptor.
+ * @index: The pool index of the buffer, returned with the completion.
+ * @buf: The buffer.
+ * @len: The number of bytes to write.
+ * @off: The file offset, or -1 for streams.
+ */
+void uring_ring_queue(uring_t *r, int fd, int index, char *buf, int len,
+		off_t off)
+{
+	unsigned int tail = *r->sq_tail, slot = tail & *r->sq_mask;
+	struct io_uring_sqe *sqe = (struct io_uring_sqe *)r->sqes + slot;
+
+	memset(sqe, 0, sizeof(*sqe));
+	sqe->opcode = r->fixed ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+	sqe->fd = fd;
+	sqe->addr = (unsigned long)buf;
+	sqe->len = len;
+	sqe->off = off;
+	sqe->buf_index = r->fixed ? index : 0;
+	sqe->user_data = index;
+	if (off == -1)
+		sqe->flags = IOSQE_IO_DRAIN;
+	r->sq_array[slot] = slot;
+	__atomic_store_n(r->sq_tail, tail + 1, __ATOMIC_RELEASE);
+	r->queued++;
+	r->pending++;
+}
+
+/**
+ * uring_ring_submit - Submit the queued writes, optionally waiting.
+ *
+ * @r: The ring.
+ * @wait: Non-zero to block until at least one write has completed.
+ *
+ * Return: 0 on success, -1 on failure.
+ */
+int uring_ring_submit(uring_t *r, int wait)
+{
+	int ret;
+
+	do {
+		ret = syscall(__NR_io_uring_enter, r->ring_fd, r->queued,
+				wait ? 1 : 0, wait ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+	} while (ret < 0 && errno == EINTR);
+	if (ret < 0)
+		return (-1);
+	r->queued -= ret;
+
+	return (0);
+}
+
+/**
+ * uring_ring_reap - Take one completion off the completion ring.
+ *
+ * @r: The ring.
+ * @index: Receives the pool index of the completed buffer.
+ * @res: Receives the write result (bytes written or -errno).
+ *
+ * Return: 1 if a completion was taken, 0 if there was none.
+ */
+int uring_ring_reap(uring_t *r, int *index, int *res)
+{
+	unsigned int head = *r->cq_head;
+	struct io_uring_cqe *cqe;
+
+	if (head == __atomic_load_n(r->cq_tail, __ATOMIC_ACQUIRE))
+		return (0);
+	cqe = (struct io_uring_cqe *)r->cqes + (head & *r->cq_mask);
+	*index = (int)cqe->user_data;
+	*res = cqe->res;
+	__atomic_store_n(r->cq_head, head + 1, __ATOMIC_RELEASE);
+	r->pending--;
+
+	return (1);
+}
+#else
+int uring_ring_setup(uring_t *r, unsigned int entries,
+		char *bufs, int nbufs, int bufsize)
+{
+	UNUSED(entries);
+	UNUSED(bufs);
+	UNUSED(nbufs);
+	UNUSED(bufsize);
+	memset(r, 0, sizeof(*r));
+	r->ring_fd = -1;
+	return (-1);
+}
+
+void uring_ring_queue(uring_t *r, int fd, int index, char *buf, int len,
+		off_t off)
+{
+	UNUSED(r);
+	UNUSED(fd);
+	UNUSED(index);
+	UNUSED(buf);
+	UNUSED(len);
+	UNUSED(off);
+}
+
+int uring_ring_submit(uring_t *r, int wait)
+{
+	UNUSED(r);
+	UNUSED(wait);
+	return (-1);
+}
+
+int uring_ring_reap(uring_t *r, int *index, int *res)
+{
+	UNUSED(r);
+	UNUSED(index);
+	UNUSED(res);
+	return (0);
+}
+#endif
+
+/**
+ * uring_ring_free - Wait for outstanding writes, then unmap and close.
+ *
+ * Every write the kernel still owns is waited for and its completion
+ * discarded, even after a failed write, so the caller may free the
+ * buffers afterwards. Closing the ring also unregisters its buffers.
+ * Safe to call on a ring whose setup failed part way.
+ *
+ * @r: The ring.
+ *
+ * Return: 0 on success, -1 if the ring could not be waited on; writes may
+ * then still be running and the buffers must be left allocated.
+ */
+int uring_ring_free(uring_t *r)
+{
+	int index, res, stuck = 0;
+
+	while (r->ring_fd >= 0 && r->pending > 0 && !stuck)
+	{
+		while (uring_ring_reap(r, &index, &res))
+			;
+		if (r->pending > 0 && uring_ring_submit(r, 1) == -1)
+			stuck = errno != EBUSY;
+	}
+	if (r->sqes != NULL && r->sqes != MAP_FAILED)
+		munmap(r->sqes, r->sqe_size);
+	if (r->cq_map != NULL && r->cq_map != MAP_FAILED && r->cq_map != r->sq_map)
+		munmap(r->cq_map, r->cq_size);
+	if (r->sq_map != NULL && r->sq_map != MAP_FAILED)
+		munmap(r->sq_map, r->sq_size);
+	if (r->ring_fd >= 0)
+		close(r->ring_fd);
+	memset(r, 0, sizeof(*r));
+	r->ring_fd = -1;
+
+	return (stuck ? -1 : 0);
+}
@@ -0,0 +1,191 @@
+#include "main.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+/**
+ * uring_sink_start - Queue the unwritten part of a pool buffer.
+ *
+ * @sink: The sink.
+ * @index: The pool index of the buffer.
+ */
+static void uring_sink_start(uring_sink_t *sink, int index)
+{
+	int done = sink->done[index];
+
+	uring_ring_queue(&sink->ring, sink->fd, index,
+			sink->bufs + index * URING_SINK_BUF_SIZE + done,
+			sink->lens[index] - done,
+			sink->offs[index] == -1 ? -1 :
+			sink->offs[index] + done);
+}
+
+/**
+ * uring_sink_complete - Retire the writes the kernel has finished.
+ *
+ * A short write, or one that hit EAGAIN, is queued again for its remaining
+ * bytes. A finished buffer goes back to the pool and, for streams, the
+ * next buffer in line is started, since streams keep a single write in
+ * flight to preserve ordering. Any other failure, including a write that
+ * made no progress with bytes still left, marks the writer as failed and
+ * retires the buffer, so uring_sink_close reports the lost bytes.
+ * Follow-up writes are submitted right away.
+ *
+ * @sink: The sink.
+ */
+static void uring_sink_complete(uring_sink_t *sink)
+{
+	int index, res, next;
+
+	while (uring_ring_reap(&sink->ring, &index, &res))
+	{
+		if (res > 0)
+			sink->done[index] += res;
+		if ((res > 0 || res == -EAGAIN) &&
+				sink->done[index] < sink->lens[index])
+		{
+			uring_sink_start(sink, index);
+			continue;
+		}
+		if (res < 0 || sink->done[index] < sink->lens[index])
+			sink->out.error = 1;
+		sink->lens[index] = 0;
+		sink->done[index] = 0;
+		sink->inflight--;
+		next = (index + 1) % URING_SINK_BUFS;
+		if (sink->offset == -1 && sink->lens[next] != 0)
+			uring_sink_start(sink, next);
+	}
+	if (sink->ring.queued > 0 && uring_ring_submit(&sink->ring, 0) == -1)
+		sink->out.error = 1;
+}
+
+/**
+ * uring_sink_flush - Flush callback of io_uring sinks.
+ *
+ * The current buffer is handed to the ring and the writer moves on to the
+ * next buffer of the pool at once, so formatting continues while earlier
+ * buffers are in flight. File writes are submitted URING_SINK_BATCH at a
+ * time; stream writes are started one after another as each completes.
+ * Only when the next buffer is still in flight does this wait.
+ *
+ * @out: The writer embedded in a uring_sink_t.
+ *
+ * Return: 0 on success, -1 on failure.
+ */
+static int uring_sink_flush(writer_t *out)
+{
+	uring_sink_t *sink = out->ctx;
+	int next = (sink->cur + 1) % URING_SINK_BUFS;
+
+	sink->lens[sink->cur] = out->len;
+	sink->offs[sink->cur] = sink->offset;
+	if (sink->offset != -1)
+		sink->offset += out->len;
+	if (sink->offset != -1 || sink->inflight == 0)
+		uring_sink_start(sink, sink->cur);
+	sink->inflight++;
+	if ((sink->offset == -1 || sink->ring.queued >= URING_SINK_BATCH) &&
+			sink->ring.queued > 0 &&
+			uring_ring_submit(&sink->ring, 0) == -1)
+		out->error = 1;
+
+	uring_sink_complete(sink);
+	while (sink->lens[next] != 0 && !out->error)
+	{
+		if (uring_ring_submit(&sink->ring, 1) == -1)
+			out->error = 1;
+		uring_sink_complete(sink);
+	}
+
+	sink->cur = next;
+	out->buf = sink->bufs + next * URING_SINK_BUF_SIZE;
+	out->len = 0;
+
+	return (out->error ? -1 : 0);
+}
+
+/**
+ * uring_sink_open - Set up batched asynchronous output to a descriptor.
+ *
+ * A pool of URING_SINK_BUFS buffers is allocated and registered with a new
+ * io_uring. Regular files opened without O_APPEND are written at explicit
+ * offsets starting from the current position, many buffers at a time;
+ * everything else is written as a stream with one write in flight. When
+ * io_uring is not available (old kernel, seccomp, non-Linux) the sink
+ * falls back to plain write(2) from a single buffer. Format into it with
+ * _wprintf(&sink->out, ...); the sink must only be used by one thread at
+ * a time.
+ *
+ * @sink: The sink to initialize.
+ * @fd: The destination file descriptor; it is not closed by the sink.
+ *
+ * Return: 0 on success, -1 if the buffers cannot be allocated.
+ */
+int uring_sink_open(uring_sink_t *sink, int fd)
+{
+	struct stat st;
+	void *bufs;
+
+	memset(sink->lens, 0, sizeof(sink->lens));
+	memset(sink->done, 0, sizeof(sink->done));
+	sink->fd = fd;
+	sink->cur = 0;
+	sink->inflight = 0;
+	sink->offset = -1;
+	if (posix_memalign(&bufs, 4096, URING_SINK_BUFS * URING_SINK_BUF_SIZE))
+		return (-1);
+	sink->bufs = bufs;
+	writer_init(&sink->out, sink->bufs, URING_SINK_BUF_SIZE, sink->scratch,
+			fd);
+
+	if (uring_ring_setup(&sink->ring, URING_SINK_BUFS, sink->bufs,
+				URING_SINK_BUFS, URING_SINK_BUF_SIZE) == -1)
+		return (0);
+
+	if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) &&
+			!(fcntl(fd, F_GETFL) & O_APPEND))
+		sink->offset = lseek(fd, 0, SEEK_CUR);
+	sink->out.flush = uring_sink_flush;
+	sink->out.ctx = sink;
+
+	return (0);
+}
+
+/**
+ * uring_sink_close - Write out everything and release an io_uring sink.
+ *
+ * Pending output is queued, and writes are submitted and waited for until
+ * all are done or one fails; for files the descriptor's position is then
+ * moved past the queued data. After a failure no further buffers are
+ * started and their output is lost, which the return value reports. The
+ * writes the kernel already owns are waited for by uring_ring_free before
+ * the buffers are freed; if the ring cannot be waited on they are leaked
+ * instead.
+ *
+ * @sink: The sink to close.
+ *
+ * Return: 0 on success, -1 if any output was lost.
+ */
+int uring_sink_close(uring_sink_t *sink)
+{
+	writer_flush(&sink->out);
+	while (sink->ring.ring_fd >= 0 && sink->inflight > 0 &&
+			!sink->out.error)
+	{
+		if (uring_ring_submit(&sink->ring, 1) == -1)
+			sink->out.error = 1;
+		uring_sink_complete(sink);
+	}
+	if (sink->ring.ring_fd >= 0)
+	{
+		if (sink->offset != -1)
+			lseek(sink->fd, sink->offset, SEEK_SET);
+		if (uring_ring_free(&sink->ring) == -1)
+			return (-1);
+	}
+	free(sink->bufs);
+
+	return (sink->out.error ? -1 : 0);
+}
@@ -0,0 +1,180 @@
+#include "main.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/**
+ * utf8_ascii_len - Measure a string and check whether it is pure ASCII.
+ *
+ * With SSE2 the string is scanned 16 bytes at a time for the terminating
+ * NUL and for bytes with the high bit set in the same pass. The loads are
+ * aligned, so they never cross into a page the string does not touch.
+ *
+ * @s: The NUL-terminated string.
+ * @is_ascii: Set to 1 if no byte of @s is above 0x7F, else 0.
+ *
+ * Return: The length of @s in bytes.
+ */
+int utf8_ascii_len(const char *s, int *is_ascii)
+{
+#ifdef __SSE2__
+	unsigned int off = (unsigned long)s & 15, zmask, hmask, high = 0;
+	const char *p = s - off;
+	__m128i v, zero = _mm_setzero_si128();
+
+	for (;; p += 16, off = 0)
+	{
+		v = _mm_load_si128((const __m128i *)p);
+		zmask = (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(v, zero));
+		hmask = (unsigned int)_mm_movemask_epi8(v);
+		zmask = zmask >> off << off;
+		hmask = hmask >> off << off;
+		if (zmask)
+		{
+			high |= hmask & ((zmask & -zmask) - 1);
+			break;
+		}
+		high |= hmask;
+	}
+	*is_ascii = !high;
+
+	return (p + __builtin_ctz(zmask) - s);
+#else
+	int len = 0, high = 0;
+
+	while (s[len] != '\0')
+		high |= (unsigned char)s[len++] & 0x80;
+	*is_ascii = !high;
+
+	return (len);
+#endif
+}
+
+/**
+ * utf8_decode - Decode one UTF-8 sequence.
+ *
+ * @s: The sequence; reading stops at a NUL byte.
+ * @cp: Receives the code point, U+FFFD for a malformed sequence.
+ *
+ * Return: The number of bytes consumed (a malformed byte counts as one).
+ */
+static int utf8_decode(const unsigned char *s, unsigned int *cp)
+{
+	int n, i;
+
+	if (s[0] < 0x80)
+		return (*cp = s[0], 1);
+	n = s[0] >= 0xF5 ? 0 : s[0] >= 0xF0 ? 4 : s[0] >= 0xE0 ? 3 :
+		s[0] >= 0xC2 ? 2 : 0;
+	*cp = 0xFFFD;
+	if (n == 0)
+		return (1);
+	for (i = 1; i < n; i++)
+		if ((s[i] & 0xC0) != 0x80)
+			return (1);
+
+	*cp = n == 2 ? (s[0] & 0x1Fu) << 6 | (s[1] & 0x3F) :
+		n == 3 ? (s[0] & 0x0Fu) << 12 | (s[1] & 0x3Fu) << 6 | (s[2] & 0x3F) :
+		(s[0] & 0x07u) << 18 | (s[1] & 0x3Fu) << 12 | (s[2] & 0x3Fu) << 6 |
+		(s[3] & 0x3F);
+	if ((n == 3 && (*cp < 0x800 || (*cp >= 0xD800 && *cp < 0xE000))) ||
+			(n == 4 && (*cp < 0x10000 || *cp > 0x10FFFF)))
+		return (*cp = 0xFFFD, 1);
+
+	return (n);
+}
+
+/**
+ * utf8_encode - Encode one code point as UTF-8.
+ *
+ * Surrogates and values above U+10FFFF are encoded as U+FFFD.
+ *
+ * @cp: The code point.
+ * @dst: Receives up to 4 bytes.
+ *
+ * Return: The number of bytes written.
+ */
+int utf8_encode(unsigned int cp, char *dst)
+{
+	if (cp < 0x80)
+		return (dst[0] = cp, 1);
+	if (cp < 0x800)
+	{
+		dst[0] = 0xC0 | cp >> 6, dst[1] = 0x80 | (cp & 0x3F);
+		return (2);
+	}
+	if ((cp >= 0xD800 && cp < 0xE000) || cp > 0x10FFFF)
+		cp = 0xFFFD;
+	if (cp < 0x10000)
+	{
+		dst[0] = 0xE0 | cp >> 12, dst[1] = 0x80 | (cp >> 6 & 0x3F);
+		dst[2] = 0x80 | (cp & 0x3F);
+		return (3);
+	}
+	dst[0] = 0xF0 | cp >> 18, dst[1] = 0x80 | (cp >> 12 & 0x3F);
+	dst[2] = 0x80 | (cp >> 6 & 0x3F), dst[3] = 0x80 | (cp & 0x3F);
+
+	return (4);
+}
+
+/**
+ * utf8_span - Find how much of a UTF-8 string fits in a precision.
+ *
+ * @s: The string.
+ * @len: Its length in bytes.
+ * @mode: The width mode the precision is counted in.
+ * @precision: The limit in width units, or -1 for none.
+ * @units: Receives the width units of the part that fits.
+ *
+ * Return: The number of bytes that fit, always whole sequences.
+ */
+static int utf8_span(const char *s, int len, int mode, int precision,
+		int *units)
+{
+	int i = 0, n, u;
+	unsigned int cp;
+
+	*units = 0;
+	while (i < len)
+	{
+		n = utf8_decode((const unsigned char *)s + i, &cp);
+		u = mode == WIDTH_BYTES ? n : utf8_units(cp, mode);
+		if (precision >= 0 && *units + u > precision)
+			break;
+		*units += u;
+		i += n;
+	}
+
+	return (i);
+}
+
+/**
+ * print_utf8_value - Print a UTF-8 string counting width in code points
+ * or columns.
+ *
+ * print_string_value hands non-ASCII strings here when a width mode other
+ * than WIDTH_BYTES is set. Precision drops whole sequences only.
+ *
+ * @str: The string.
+ * @len: Its length in bytes.
+ * @out: The writer receiving the output.
+ * @spec: The parsed directive; width and precision are in width units.
+ *
+ * Return: The number of bytes printed.
+ */
+int print_utf8_value(const char *str, int len, writer_t *out,
+		const spec_t *spec)
+{
+	int units, bytes, pad;
+
+	bytes = utf8_span(str, len, utf8_width_mode(), spec->precision, &units);
+	pad = spec->width > units ? spec->width - units : 0;
+
+	if (!(spec->flags & F_MINUS))
+		writer_pad(out, ' ', pad);
+	writer_write(out, str, bytes);
+	if (spec->flags & F_MINUS)
+		writer_pad(out, ' ', pad);
+
+	return (bytes + pad);
+}
@@ -0,0 +1,99 @@
+#include "main.h"
+
+/*
+ * How width and precision of %s, %ls and %lc are counted. Process-wide,
+ * read with relaxed atomics on every string conversion.
+ */
+static int width_mode = WIDTH_BYTES;
+
+/**
+ * utf8_columns - Terminal columns taken by a code point.
+ *
+ * A compact range table in the spirit of wcwidth: combining marks and
+ * zero-width characters take no column, East Asian wide and fullwidth
+ * characters and emoji take two, everything else takes one.
+ *
+ * @cp: The code point.
+ *
+ * Return: 0, 1 or 2.
+ */
+static int utf8_columns(unsigned int cp)
+{
+	static const unsigned int ranges[][3] = {
+		{0x0300, 0x036F, 0}, {0x0483, 0x0489, 0}, {0x0591, 0x05BD, 0},
+		{0x0610, 0x061A, 0}, {0x064B, 0x065F, 0}, {0x0E31, 0x0E3A, 0},
+		{0x1100, 0x115F, 2}, {0x1AB0, 0x1AFF, 0}, {0x1DC0, 0x1DFF, 0},
+		{0x200B, 0x200F, 0}, {0x20D0, 0x20FF, 0}, {0x2E80, 0x303E, 2},
+		{0x3041, 0x33FF, 2}, {0x3400, 0x4DBF, 2}, {0x4E00, 0x9FFF, 2},
+		{0xA000, 0xA4CF, 2}, {0xAC00, 0xD7A3, 2}, {0xF900, 0xFAFF, 2},
+		{0xFE00, 0xFE0F, 0}, {0xFE20, 0xFE2F, 0}, {0xFE30, 0xFE4F, 2},
+		{0xFF00, 0xFF60, 2}, {0xFFE0, 0xFFE6, 2}, {0x1F300, 0x1F64F, 2},
+		{0x1F900, 0x1F9FF, 2}, {0x20000, 0x2FFFD, 2}, {0x30000, 0x3FFFD, 2}};
+	int lo = 0, hi = sizeof(ranges) / sizeof(ranges[0]) - 1, mid;
+
+	if (cp < 0x0300)
+		return (1);
+	while (lo <= hi)
+	{
+		mid = (lo + hi) / 2;
+		if (cp < ranges[mid][0])
+			hi = mid - 1;
+		else if (cp > ranges[mid][1])
+			lo = mid + 1;
+		else
+			return (ranges[mid][2]);
+	}
+
+	return (1);
+}
+
+/**
+ * utf8_units - Width units a code point counts for in a width mode.
+ *
+ * @cp: The code point.
+ * @mode: WIDTH_BYTES, WIDTH_CODEPOINTS or WIDTH_COLUMNS.
+ *
+ * Return: Its UTF-8 length, 1, or its terminal columns.
+ */
+int utf8_units(unsigned int cp, int mode)
+{
+	if (mode == WIDTH_CODEPOINTS)
+		return (1);
+	if (mode == WIDTH_COLUMNS)
+		return (utf8_columns(cp));
+
+	return (cp < 0x80 ? 1 : cp < 0x800 ? 2 : cp < 0x10000 ? 3 : 4);
+}
+
+/**
+ * _printf_set_width_mode - Choose how string width and precision count.
+ *
+ * With WIDTH_BYTES (the default) %s counts bytes as it always has. With
+ * WIDTH_CODEPOINTS or WIDTH_COLUMNS, width and precision of %s, %ls and
+ * %lc count code points or terminal columns, and precision never splits
+ * a multibyte sequence, so padded columns of non-ASCII text line up.
+ *
+ * @mode: WIDTH_BYTES, WIDTH_CODEPOINTS or WIDTH_COLUMNS.
+ *
+ * Return: 0 on success, -1 if @mode is not a width mode.
+ */
+int _printf_set_width_mode(int mode)
+{
+	if (mode != WIDTH_BYTES && mode != WIDTH_CODEPOINTS &&
+			mode != WIDTH_COLUMNS)
+		return (-1);
+
+	__atomic_store_n(&width_mode, mode, __ATOMIC_RELAXED);
+
+	return (0);
+}
+
+/**
+ * utf8_width_mode - Get the current width mode.
+ *
+ * Return: WIDTH_BYTES, WIDTH_CODEPOINTS or WIDTH_COLUMNS.
+ */
+int utf8_width_mode(void)
+{
+	return (__atomic_load_n(&width_mode, __ATOMIC_RELAXED));
+}
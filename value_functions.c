@@ -0,0 +1,174 @@
+#include "main.h"
+
+/**
+ * print_int_value - Print a signed integer that has already been fetched.
+ *
+ * This is the body of print_int without the va_arg step, so callers that
+ * already hold the value (such as the compile-time front end in printf.hpp)
+ * can reach the decimal converter directly. The value is narrowed according
+ * to the size specifier exactly as print_int does.
+ *
+ * @n: The integer to print.
+ * @out: The writer receiving the output.
+ * @spec: The parsed directive (flags, width, precision, size).
+ *
+ * Return: The number of characters printed.
+ */
+int print_int_value(long int n, writer_t *out, const spec_t *spec)
+{
+	char *buffer = out->scratch;
+	int i = BUFF_SIZE - 2;
+	int is_negative = 0;
+	unsigned long int num;
+
+	n = convert_size_number(n, spec->size);
+
+	if (n == 0)
+		buffer[i--] = '0';
+
+	buffer[BUFF_SIZE - 1] = '\0';
+	num = (unsigned long int)n;
+
+	if (n < 0)
+	{
+		num = (unsigned long int)((-1) * n);
+		is_negative = 1;
+	}
+
+	while (num > 0)
+	{
+		buffer[i--] = (num % 10) + '0';
+		num /= 10;
+	}
+
+	i++;
+
+	return (write_number(is_negative, i, out, spec));
+}
+
+/**
+ * print_unsigned_value - Print an unsigned integer in a given base.
+ *
+ * Shared body of print_unsigned, print_octal, print_hexa and print_binary.
+ * Bases 2, 8 and 16 go to the shift/mask kernel print_radix_value, with
+ * the '#' flag adding the "0x"/"0X"/"0b" prefix for non-zero values;
+ * decimal digits are produced from the back of the scratch buffer. Both
+ * end in write_digits.
+ *
+ * @num: The unsigned integer to print.
+ * @base: The numeric base (2, 8, 10 or 16).
+ * @map_to: The digit characters for the base.
+ * @flag_ch: The prefix letter used with '#', or 0 for none.
+ * @out: The writer receiving the output.
+ * @spec: The parsed directive (flags, width, precision, size).
+ *
+ * Return: The number of characters printed.
+ */
+int print_unsigned_value(unsigned long int num, int base,
+		const char map_to[], char flag_ch, writer_t *out,
+		const spec_t *spec)
+{
+	char *buffer = out->scratch;
+	char prefix[3] = {'0', 0, 0};
+	int i = BUFF_SIZE, hash = spec->flags & F_HASH;
+
+	num = convert_size_unsgnd(num, spec->size);
+
+	if (base != 10)
+	{
+		prefix[1] = flag_ch;
+		return (print_radix_value(num, base == 2 ? 1 : base == 8 ? 3 : 4,
+					map_to, hash && num != 0 && flag_ch ? prefix : NULL,
+					0, out, spec));
+	}
+
+	while (num > 0)
+	{
+		buffer[--i] = map_to[num % 10];
+		num /= 10;
+	}
+	if (i == BUFF_SIZE && spec->precision != 0)
+		buffer[--i] = '0';
+
+	return (write_digits(out, buffer + i, BUFF_SIZE - i, NULL, 0, spec));
+}
+
+/**
+ * print_string_value - Print a string that has already been fetched.
+ *
+ * This function applies precision (truncation) and width (padding) to
+ * @str, printing "(null)" for a NULL pointer the same way print_string
+ * always has. Width and precision count bytes unless another width mode
+ * is set, in which case non-ASCII strings go to print_utf8_value; ASCII
+ * strings, detected while measuring, always stay on the byte path.
+ *
+ * @str: The string to print, may be NULL.
+ * @out: The writer receiving the output.
+ * @spec: The parsed directive (flags, width, precision, size).
+ *
+ * Return: The number of characters printed.
+ */
+int print_string_value(const char *str, writer_t *out, const spec_t *spec)
+{
+	int length, ascii, width = spec->width;
+
+	if (str == NULL)
+	{
+		str = "(null)";
+		if (spec->precision >= 6)
+			str = "      ";
+	}
+
+	length = utf8_ascii_len(str, &ascii);
+	if (!ascii && utf8_width_mode() != WIDTH_BYTES)
+		return (print_utf8_value(str, length, out, spec));
+
+	if (spec->precision >= 0 && spec->precision < length)
+		length = spec->precision;
+
+	if (width > length)
+	{
+		if (spec->flags & F_MINUS)
+			return (writer_write(out, str, length) +
+					writer_pad(out, ' ', width - length));
+		return (writer_pad(out, ' ', width - length) +
+				writer_write(out, str, length));
+	}
+
+	return (writer_write(out, str, length));
+}
+
+/**
+ * print_pointer_value - Print a pointer address that has already been
+ * fetched.
+ *
+ * The address is printed in lowercase hexadecimal after "0x" by the radix
+ * kernel, with the optional '+' or ' ' character, precision and padding.
+ * A NULL pointer prints as "(nil)", padded to the width.
+ *
+ * @addrs: The address to print.
+ * @out: The writer receiving the output.
+ * @spec: The parsed directive (flags, width, precision, size).
+ *
+ * Return: The number of characters printed for the pointer address.
+ */
+int print_pointer_value(const void *addrs, writer_t *out,
+		const spec_t *spec)
+{
+	spec_t nil = *spec;
+	char sign = 0;
+
+	if (addrs == NULL)
+	{
+		nil.precision = -1;
+		return (print_string_value("(nil)", out, &nil));
+	}
+
+	if (spec->flags & F_PLUS)
+		sign = '+';
+	else if (spec->flags & F_SPACE)
+		sign = ' ';
+
+	return (print_radix_value((unsigned long)addrs, 4, "0123456789abcdef",
+				"0x", sign, out, spec));
+}
@@ -0,0 +1,137 @@
+#include "main.h"
+#if defined(__SSE2__) && WCHAR_MAX > 0xFFFF
+#include <emmintrin.h>
+#define WIDE_SSE2
+#endif
+
+/**
+ * wide_encode - Transcode wide characters to UTF-8.
+ *
+ * With SSE2 and 32-bit wchar_t, eight characters are checked at once and,
+ * when all are ASCII, narrowed to eight bytes with two pack instructions.
+ * Other blocks are encoded one character at a time.
+ *
+ * @ws: The wide characters.
+ * @n: How many to encode.
+ * @dst: Receives up to 4 * @n bytes.
+ *
+ * Return: The number of bytes written.
+ */
+static int wide_encode(const wchar_t *ws, int n, char *dst)
+{
+	int i = 0, len = 0, end;
+#ifdef WIDE_SSE2
+	__m128i a, b, zero = _mm_setzero_si128(), high = _mm_set1_epi32(~0x7F);
+#endif
+
+	while (i < n)
+	{
+#ifdef WIDE_SSE2
+		if (i + 8 <= n)
+		{
+			a = _mm_loadu_si128((const __m128i *)(ws + i));
+			b = _mm_loadu_si128((const __m128i *)(ws + i + 4));
+			if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(
+					_mm_or_si128(a, b), high), zero)) == 0xFFFF)
+			{
+				_mm_storel_epi64((__m128i *)(dst + len),
+						_mm_packus_epi16(_mm_packs_epi32(a, b), zero));
+				i += 8, len += 8;
+				continue;
+			}
+		}
+#endif
+		for (end = i + 8 < n ? i + 8 : n; i < end; i++)
+			len += utf8_encode((unsigned int)ws[i], dst + len);
+	}
+
+	return (len);
+}
+
+/**
+ * wide_span - Find how many wide characters fit in a precision.
+ *
+ * @ws: The NUL-terminated wide string.
+ * @mode: The width mode the precision is counted in.
+ * @precision: The limit in width units, or -1 for none.
+ * @units: Receives the width units of the characters that fit.
+ *
+ * Return: The number of characters that fit.
+ */
+static int wide_span(const wchar_t *ws, int mode, int precision, int *units)
+{
+	int n, u;
+
+	*units = 0;
+	for (n = 0; ws[n] != 0; n++)
+	{
+		u = utf8_units((unsigned int)ws[n] > 0x10FFFF ? 0xFFFD :
+				(unsigned int)ws[n], mode);
+		if (precision >= 0 && *units + u > precision)
+			break;
+		*units += u;
+	}
+
+	return (n);
+}
+
+/**
+ * print_wide_value - Print a wide string as UTF-8.
+ *
+ * Width and precision count UTF-8 bytes by default, as C's %ls does, or
+ * code points or columns under _printf_set_width_mode; either way a
+ * character is never split. A NULL pointer prints like a NULL %s.
+ *
+ * @ws: The wide string, may be NULL.
+ * @out: The writer receiving the output.
+ * @spec: The parsed directive; width and precision are in width units.
+ *
+ * Return: The number of bytes printed.
+ */
+int print_wide_value(const wchar_t *ws, writer_t *out, const spec_t *spec)
+{
+	int i, n, chunk, units, bytes = 0, pad;
+
+	if (ws == NULL)
+		return (print_string_value(NULL, out, spec));
+
+	n = wide_span(ws, utf8_width_mode(), spec->precision, &units);
+	pad = spec->width > units ? spec->width - units : 0;
+
+	if (!(spec->flags & F_MINUS))
+		writer_pad(out, ' ', pad);
+	for (i = 0; i < n; i += chunk)
+	{
+		chunk = n - i < BUFF_SIZE / 4 ? n - i : BUFF_SIZE / 4;
+		bytes += writer_write(out, out->scratch,
+				wide_encode(ws + i, chunk, out->scratch));
+	}
+	if (spec->flags & F_MINUS)
+		writer_pad(out, ' ', pad);
+
+	return (bytes + pad);
+}
+
+/**
+ * print_wide_char - Print a wide character as UTF-8.
+ *
+ * @c: The wide character.
+ * @out: The writer receiving the output.
+ * @spec: The parsed directive; precision is ignored.
+ *
+ * Return: The number of bytes printed.
+ */
+int print_wide_char(wint_t c, writer_t *out, const spec_t *spec)
+{
+	wchar_t ws[2];
+	spec_t one = *spec;
+
+	if (c == 0)
+		return (handle_write_char('\0', out, spec));
+
+	ws[0] = c;
+	ws[1] = 0;
+	one.precision = -1;
+
+	return (print_wide_value(ws, out, &one));
+}
@@ -1,68 +1,5 @@
 #include "main.h"
 
-/**
- * write_unsgnd - Write an unsigned number to a character buffer
- * with formatting.
- *
- * This function writes an unsigned number to the character buffer with the
- * specified formatting options, including width, precision, and padding.
- * It also considers whether the number is negative (0 for unsigned).
- *
- * @is_negative: A flag indicating whether the number is negative.
- * @ind: The current index in the buffer where writing starts.
- * @buffer: The character buffer to write the number to.
- * @flags: Formatting flags (e.g., F_MINUS for left-align).
- * @width: The total width of the output, including padding (if any).
- * @precision: The precision specification for the number.
- * @size: The size specifier for the number (e.g., S_LONG, S_SHORT).
- *
- * Return: The number of characters written to the buffer.
- */
-int write_unsgnd(int is_negative, int ind,
-				 char buffer[],
-				 int flags, int width, int precision, int size)
-{
-	int length = BUFF_SIZE - ind - 1, i = 0;
-	char padd = ' ';
-
-	UNUSED(is_negative);
-	UNUSED(size);
-
-	if (precision == 0 && ind == BUFF_SIZE - 2 && buffer[ind] == '0')
-		return (0);
-
-	if (precision > 0 && precision < length)
-		padd = ' ';
-
-	while (precision > length)
-	{
-		buffer[--ind] = '0';
-		length++;
-	}
-
-	if ((flags & F_ZERO) && !(flags & F_MINUS))
-		padd = '0';
-
-	if (width > length)
-	{
-		for (i = 0; i < width - length; i++)
-			buffer[i] = padd;
-
-		buffer[i] = '\0';
-
-		if (flags & F_MINUS)
-		{
-			return (write(1, &buffer[ind], length) + write(1, &buffer[0], i));
-		}
-		else
-		{
-			return (write(1, &buffer[0], i) + write(1, &buffer[ind], length));
-		}
-	}
-
-	return (write(1, &buffer[ind], length));
-}
-
 /**
  * write_number - Write a numeric value to a character buffer with formatting.
  *
@@ -72,22 +9,18 @@ int write_unsgnd(int is_negative, int ind,
  *
  * @is_negative: A flag indicating whether the number is negative.
  * @ind: The current index in the buffer where writing starts.
- * @buffer: The character buffer to write the numeric value to.
- * @flags: Formatting flags (e.g., F_MINUS for left-align).
- * @width: The total width of the output, including padding (if any).
- * @precision: The precision specification for the numeric value.
- * @size: The size specifier for the numeric value (e.g., S_LONG, S_SHORT).
+ * @out: The writer receiving the output; its scratch space holds
+ * the digits being formatted.
+ * @spec: The parsed directive (flags, width, precision, size).
  *
  * Return: The number of characters written to the buffer.
  */
-int write_number(int is_negative, int ind, char buffer[],
-				 int flags, int width, int precision, int size)
+int write_number(int is_negative, int ind, writer_t *out,
+				 const spec_t *spec)
 {
-	int length = BUFF_SIZE - ind - 1;
+	int length = BUFF_SIZE - ind - 1, flags = spec->flags;
 	char padd = ' ', extra_ch = 0;
 
-	UNUSED(size);
-
 	if ((flags & F_ZERO) && !(flags & F_MINUS))
 		padd = '0';
 	if (is_negative)
@@ -97,55 +30,42 @@ int write_number(int is_negative, int ind, char buffer[],
 	else if (flags & F_SPACE)
 		extra_ch = ' ';
 
-	return (write_num(ind, buffer, flags, width, precision,
+	return (write_num(ind, out, flags, spec->width, spec->precision,
 					  length, padd, extra_ch));
 }
 
 /**
- * handle_write_char - Write a character to a character buffer with formatting.
+ * handle_write_char - Write a character with formatting.
  *
- * This function handles writing a character to the character buffer with
- * the specified formatting options, including width, padding, and alignment.
+ * This function writes a character with the specified formatting options,
+ * including width, padding, and alignment. The padding is streamed with
+ * writer_pad, so any width works whatever the size of the buffers.
  *
  * @c: The character to be written.
- * @buffer: The character buffer to write the character to.
- * @flags: Formatting flags (e.g., F_MINUS for left-align).
- * @width: The total width of the output, including padding (if any).
- * @precision: The precision specification for the character.
- * @size: Size specifier.
+ * @out: The writer receiving the output.
+ * @spec: The parsed directive; precision and size are ignored.
  *
- * Return: The number of characters written to the buffer.
+ * Return: The number of characters written.
  */
-int handle_write_char(char c, char buffer[],
-					  int flags, int width, int precision, int size)
+int handle_write_char(char c, writer_t *out, const spec_t *spec)
 {
-	int i = 0;
+	int width = spec->width;
 	char padd = ' ';
 
-	UNUSED(precision);
-	UNUSED(size);
-
-	if (flags & F_ZERO)
+	if (spec->flags & F_ZERO)
 		padd = '0';
 
-	buffer[i++] = c;
-	buffer[i] = '\0';
-
 	if (width > 1)
 	{
-		buffer[BUFF_SIZE - 1] = '\0';
-		for (i = 0; i < width - 1; i++)
-			buffer[BUFF_SIZE - i - 2] = padd;
-
-		if (flags & F_MINUS)
-			return (write(1, &buffer[0], 1) +
-					write(1, &buffer[BUFF_SIZE - i - 1], width - 1));
+		if (spec->flags & F_MINUS)
+			return (writer_write(out, &c, 1) +
+					writer_pad(out, padd, width - 1));
 		else
-			return (write(1, &buffer[BUFF_SIZE - i - 1], width - 1) +
-					write(1, &buffer[0], 1));
+			return (writer_pad(out, padd, width - 1) +
+					writer_write(out, &c, 1));
 	}
 
-	return (write(1, &buffer[0], 1));
+	return (writer_write(out, &c, 1));
 }
 
 /**
@@ -153,10 +73,16 @@ int handle_write_char(char c, char buffer[],
  *
  * This function writes a numeric value to the character buffer with the
  * specified formatting options, including width, precision, padding,
- * and extra characters.
+ * and extra characters. Only the digits live in the scratch space; the
+ * sign, precision zeros and padding are streamed around them, so width
+ * and precision are not limited by BUFF_SIZE. As in C printf, and as in
+ * the array and unsigned conversions, a precision turns '0' padding into
+ * spaces, and a zero printed with precision 0 has no digits but keeps its
+ * sign and padding.
  *
  * @ind: The current index in the buffer where writing starts.
- * @buffer: The character buffer to write the numeric value to.
+ * @out: The writer receiving the output; its scratch space holds
+ * the digits being formatted.
  * @flags: Formatting flags (e.g., F_MINUS for left-align).
  * @width: The total width of the output, including padding (if any).
  * @prec: The precision specification for the numeric value.
@@ -166,111 +92,34 @@ int handle_write_char(char c, char buffer[],
  *
  * Return: The number of characters written to the buffer.
  */
-int write_num(int ind, char buffer[],
+int write_num(int ind, writer_t *out,
 			  int flags, int width, int prec,
 			  int length, char padd, char extra_c)
 {
-	int i, padd_start = 1;
+	char *buffer = out->scratch;
+	int digits = length, zeros = 0, pad = 0;
 
-	if (prec == 0 && ind == BUFF_SIZE - 2 && buffer[ind] == '0' && width == 0)
-		return (0);
 	if (prec == 0 && ind == BUFF_SIZE - 2 && buffer[ind] == '0')
-		buffer[ind] = padd = ' ';
-	if (prec > 0 && prec < length)
+		digits = length = 0;
+	if (prec >= 0)
 		padd = ' ';
-	while (prec > length)
-		buffer[--ind] = '0', length++;
+	if (prec > length)
+		zeros = prec - length, length = prec;
 	if (extra_c != 0)
 		length++;
 	if (width > length)
-	{
-		for (i = 1; i < width - length + 1; i++)
-			buffer[i] = padd;
-		buffer[i] = '\0';
-		if (flags & F_MINUS && padd == ' ')
-		{
-			if (extra_c)
-				buffer[--ind] = extra_c;
-			return (write(1, &buffer[ind], length) + write(1, &buffer[1], i - 1));
-		}
-		else if (!(flags & F_MINUS) && padd == ' ')
-		{
-			if (extra_c)
-				buffer[--ind] = extra_c;
-			return (write(1, &buffer[1], i - 1) + write(1, &buffer[ind], length));
-		}
-		else if (!(flags & F_MINUS) && padd == '0')
-		{
-			if (extra_c)
-				buffer[--padd_start] = extra_c;
-			return (write(1, &buffer[padd_start], i - padd_start) +
-					write(1, &buffer[ind], length - (1 - padd_start)));
-		}
-	}
-	if (extra_c)
-		buffer[--ind] = extra_c;
-	return (write(1, &buffer[ind], length));
-}
+		pad = width - length;
 
-/**
- * write_pointer - Write a pointer's hexadecimal representation
- * to a character buffer with formatting.
- *
- * This function writes a pointer's hexadecimal representation to the
- * character buffer with the specified formatting options, including width,
- * padding, extra characters, and alignment.
- *
- * @buffer: The character buffer to write the pointer representation to.
- * @ind: The current index in the buffer where writing starts.
- * @length: The length of the pointer representation.
- * @width: The total width of the output, including padding (if any).
- * @flags: Formatting flags (e.g., F_MINUS for left-align).
- * @padd: The padding character (' ' or '0').
- * @extra_c: An extra character to include (e.g., '+', ' ').
- * @padd_start: The starting index for padding (0 or 3 if '0x' is present).
- *
- * Return: The number of characters written to the buffer.
- */
-int write_pointer(char buffer[], int ind, int length,
-				  int width, int flags, char padd, char extra_c, int padd_start)
-{
-	int i;
-
-	if (width > length)
-	{
-		for (i = 3; i < width - length + 3; i++)
-			buffer[i] = padd;
-		buffer[i] = '\0';
-		if (flags & F_MINUS && padd == ' ')
-		{
-			buffer[--ind] = 'x';
-			buffer[--ind] = '0';
-			if (extra_c)
-				buffer[--ind] = extra_c;
-			return (write(1, &buffer[ind], length) + write(1, &buffer[3], i - 3));
-		}
-		else if (!(flags & F_MINUS) && padd == ' ')
-		{
-			buffer[--ind] = 'x';
-			buffer[--ind] = '0';
-			if (extra_c)
-				buffer[--ind] = extra_c;
-			return (write(1, &buffer[3], i - 3) + write(1, &buffer[ind], length));
-		}
-		else if (!(flags & F_MINUS) && padd == '0')
-		{
-			if (extra_c)
-				buffer[--padd_start] = extra_c;
-			buffer[1] = '0';
-			buffer[2] = 'x';
-			return (write(1, &buffer[padd_start], i - padd_start) +
-					write(1, &buffer[ind], length - (1 - padd_start) - 2));
-		}
-	}
-	buffer[--ind] = 'x';
-	buffer[--ind] = '0';
+	if (pad && padd == ' ' && !(flags & F_MINUS))
+		writer_pad(out, ' ', pad);
 	if (extra_c)
-		buffer[--ind] = extra_c;
-	return (write(1, &buffer[ind], BUFF_SIZE - ind - 1));
+		writer_write(out, &extra_c, 1);
+	if (pad && padd == '0' && !(flags & F_MINUS))
+		writer_pad(out, '0', pad);
+	writer_pad(out, '0', zeros);
+	writer_write(out, &buffer[ind], digits);
+	if (pad && padd == ' ' && (flags & F_MINUS))
+		writer_pad(out, ' ', pad);
+
+	return (length + (padd == '0' && (flags & F_MINUS) ? 0 : pad));
 }
-
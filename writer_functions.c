@@ -0,0 +1,157 @@
+#include "main.h"
+#include <errno.h>
+
+/**
+ * writer_init - Prepare a writer that flushes to a file descriptor.
+ *
+ * This function sets up @out to stage output in @buf and hand it to
+ * print_buffer, which writes it to @fd. Other sinks start from this and
+ * replace the flush callback and context.
+ *
+ * @out: The writer to initialize.
+ * @buf: The staging buffer.
+ * @cap: The capacity of @buf.
+ * @scratch: BUFF_SIZE bytes of conversion scratch space.
+ * @fd: The destination file descriptor.
+ */
+void writer_init(writer_t *out, char *buf, int cap, char *scratch, int fd)
+{
+	out->buf = buf;
+	out->cap = cap;
+	out->len = 0;
+	out->error = 0;
+	out->flush = print_buffer;
+	out->fd = fd;
+	out->ctx = NULL;
+	out->scratch = scratch;
+	out->hashing = 0;
+	out->hash_len = 0;
+	out->hash = 0;
+	out->hash_tail = 0;
+	out->safe = 0;
+	out->prof_flush = 0;
+}
+
+/**
+ * writer_write - Append bytes to a writer.
+ *
+ * This function copies @n bytes into the staging buffer, flushing it to
+ * the sink each time it fills up. A failed sink is recorded in the writer
+ * and does not change the returned count, so converters can keep summing
+ * lengths the way they always have; the remaining bytes are dropped. A
+ * hashing writer also feeds every chunk to writer_hash as it is copied.
+ *
+ * @out: The writer to append to.
+ * @s: The bytes to append.
+ * @n: The number of bytes.
+ *
+ * Return: @n.
+ */
+int writer_write(writer_t *out, const char *s, int n)
+{
+	int i, chunk;
+
+	for (i = 0; i < n; i += chunk)
+	{
+		if (out->len == out->cap && writer_flush(out) == -1)
+			break;
+		chunk = out->cap - out->len;
+		if (chunk > n - i)
+			chunk = n - i;
+		memcpy(&out->buf[out->len], &s[i], chunk);
+		if (out->hashing)
+			writer_hash(out, &s[i], chunk);
+		out->len += chunk;
+	}
+
+	return (n);
+}
+
+/**
+ * writer_pad - Append a run of identical bytes to a writer.
+ *
+ * @out: The writer to append to.
+ * @c: The padding character.
+ * @n: How many times to repeat @c; nothing is written if @n <= 0.
+ *
+ * Return: The number of bytes appended.
+ */
+int writer_pad(writer_t *out, char c, int n)
+{
+	int i, chunk;
+
+	for (i = 0; i < n; i += chunk)
+	{
+		if (out->len == out->cap && writer_flush(out) == -1)
+			break;
+		chunk = out->cap - out->len;
+		if (chunk > n - i)
+			chunk = n - i;
+		memset(&out->buf[out->len], c, chunk);
+		if (out->hashing)
+			writer_hash(out, &out->buf[out->len], chunk);
+		out->len += chunk;
+	}
+
+	return (n > 0 ? n : 0);
+}
+
+/**
+ * writer_flush - Hand the pending bytes of a writer to its sink.
+ *
+ * @out: The writer to flush.
+ *
+ * Return: 0 on success, -1 if the sink has failed.
+ */
+int writer_flush(writer_t *out)
+{
+	int len = out->len;
+	PROF_VAR(t);
+
+	if (len > 0)
+	{
+		PROF_START(out, t);
+		if (out->error)
+			out->len = 0;
+		else
+			out->flush(out);
+		PROF_END(out, PROF_FLUSH, 0, t, len);
+		PROF_PAUSE(out, t);
+	}
+
+	return (out->error ? -1 : 0);
+}
+
+/**
+ * fd_send - Write bytes to a file descriptor without waiting for it.
+ *
+ * Interrupted and partial writes are retried. When a non-blocking
+ * descriptor cannot take more (EAGAIN) this stops early and reports how
+ * much was written, leaving the caller to decide what to do with the rest.
+ *
+ * @fd: The destination file descriptor.
+ * @buf: The bytes to write.
+ * @len: The number of bytes.
+ *
+ * Return: The number of bytes written, or -1 on error.
+ */
+int fd_send(int fd, const char *buf, int len)
+{
+	int done = 0;
+	ssize_t n;
+
+	while (done < len)
+	{
+		n = write(fd, buf + done, len - done);
+		if (n > 0)
+			done += n;
+		else if (n == -1 && errno == EINTR)
+			continue;
+		else if (n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			break;
+		else
+			return (-1);
+	}
+
+	return (done);
+}